@@ -3,6 +3,7 @@
 
 #include "Types.hpp"
 #include "CommonReadState.hpp"
+#include "DataLayout.hpp"
 #include "ReadCommand.hpp"
 
 #include <xentara/memory/Array.hpp>
@@ -12,11 +13,13 @@
 #include <chrono>
 #include <system_error>
 #include <cstdlib>
+#include <cstdint>
 
 namespace xentara::plugins::templateDriver
 {
 
 class TemplateIoComponent;
+class DecodeTable;
 
 /// @brief Base class for inputs and outputs that can be read by an I/O transaction
 ///
@@ -34,6 +37,12 @@ public:
 	/// @brief Gets the I/O component the input belongs to
 	/// @todo give this a more descriptive name, e.g. "_device"
 	virtual auto ioComponent() const -> const TemplateIoComponent & = 0;
+
+	/// @brief Gets the address of the first byte of the input's data on the I/O component
+	virtual auto address() const noexcept -> std::uint64_t = 0;
+
+	/// @brief Gets the number of bytes the input's data occupies on the I/O component
+	virtual auto dataSize() const noexcept -> std::size_t = 0;
 	
 	/// @brief Attaches the input to its I/O transaction
 	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
@@ -41,22 +50,14 @@ public:
 	/// @param eventCount A variable that counts the total number of events than can be raised for a single update.
 	/// The maximum number of events that update() will request to be raised will be added to this variable. The caller will use this
 	/// event count to preallocate a buffer when collecting the events to raise after an update.
-	virtual auto attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void = 0;
+	/// @param pass The parts of the input's state to add to the array. Depending on the data layout, the transaction either
+	/// calls this function once with AttachPass::All, or twice, first with AttachPass::Values, and then with AttachPass::Metadata.
+	virtual auto attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void = 0;
 
-	/// @brief Updates the read state and collects the events to send
-	/// @param writeSentinel A write sentinel for the data block the data is stored in
-	/// @param timeStamp The update time stamp
-	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
-	/// containing a read error.
-	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
-	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this
-	/// list. The events will not be raised directly, because the write sentinel needs to be commited first,
-	/// which is done by the caller.
-	virtual auto updateReadState(WriteSentinel &writeSentinel,
-		std::chrono::system_clock::time_point timeStamp,
-		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
-		const CommonReadState::Changes &commonChanges,
-		PendingEventList &eventsToRaise) -> void = 0;
+	/// @brief Adds the descriptors needed to decode the input to a decode table
+	/// @param decodeTable The decode table of the read command the input is read with
+	/// @param payloadOffset The offset of the input's data within the payload of the read command
+	virtual auto addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void = 0;
 };
 
 inline AbstractInput::~AbstractInput() = default;
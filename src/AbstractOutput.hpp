@@ -8,13 +8,15 @@
 #include <xentara/memory/WriteSentinel.hpp>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <system_error>
 #include <cstdlib>
 
 namespace xentara::plugins::templateDriver
 {
 
-class WriteCommand;
+class WriteCommandBuilder;
 
 /// @brief Base class for outputs that can be written by an I/O transaction
 class AbstractOutput
@@ -29,6 +31,12 @@ public:
 	/// @brief Gets the I/O component the output belongs to
 	/// @todo give this a more descriptive name, e.g. "_device"
 	virtual auto ioComponent() const -> const TemplateIoComponent & = 0;
+
+	/// @brief Gets the address of the output's data in the I/O component
+	virtual auto address() const noexcept -> std::uint64_t = 0;
+
+	/// @brief Gets the number of bytes the output's data occupies in the I/O component
+	virtual auto dataSize() const noexcept -> std::size_t = 0;
 		
 	/// @brief Attaches the output to its I/O transaction
 	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
@@ -38,10 +46,11 @@ public:
 	/// event count to preallocate a buffer when collecting the events to raise after an update.
 	virtual auto attachOutput(memory::Array &dataArray, std::size_t &eventCount) -> void = 0;
 
-	/// @brief Adds any pending output value to a write command.
-	/// @param command The write command to add the value to.
+	/// @brief Adds any pending output value to the write commands.
+	/// @param builder The builder for the write commands. The output must encode its value into the data returned by
+	/// WriteCommandBuilder::stage().
 	/// @return This function must return *true* if data was added, or *false* if no value was pending.
-	virtual auto addToWriteCommand(WriteCommand &command) -> bool = 0;
+	virtual auto addToWriteCommand(WriteCommandBuilder &builder) -> bool = 0;
 
 	/// @brief Updates the write state and collects the events to send
 	/// @param writeSentinel A write sentinel for the data block the data is stored in
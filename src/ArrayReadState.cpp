@@ -0,0 +1,132 @@
+// Copyright (c) embedded ocean GmbH
+#include "ArrayReadState.hpp"
+
+#include "Attributes.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto ArrayReadState::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support
+	return
+		function(model::Attribute::kChangeTime);
+}
+
+auto ArrayReadState::forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool
+{
+	// Handle all the events we support
+	return
+		function(process::Event::kChanged, std::shared_ptr<process::Event>(parent, &_changedEvent));
+}
+
+auto ArrayReadState::makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
+	-> std::optional<data::ReadHandle>
+{
+	// Try each readable attribute
+	if (attribute == model::Attribute::kChangeTime)
+	{
+		return dataBlock.member(_stateHandle, &State::_changeTime);
+	}
+
+	return std::nullopt;
+}
+
+auto ArrayReadState::valueReadHandle(const DataBlock &dataBlock) const noexcept -> data::ReadHandle
+{
+	return dataBlock.array(_valuesHandle);
+}
+
+auto ArrayReadState::attach(memory::Array &dataArray, std::size_t &eventCount, std::size_t length, AttachPass pass) -> void
+{
+	_length = length;
+
+	// Add the values to the array
+	if (attachesValues(pass))
+	{
+		_valuesHandle = dataArray.appendArray<double>(length);
+	}
+
+	// Add the state to the array
+	if (attachesMetadata(pass))
+	{
+		_stateHandle = dataArray.appendObject<State>();
+
+		// Add the number of events that can be raised at once, which is just the one event we have.
+		eventCount += 1;
+	}
+}
+
+auto ArrayReadState::descriptor(std::size_t payloadOffset) noexcept -> Descriptor
+{
+	return { ._payloadOffset = payloadOffset,
+		._length = _length,
+		._stateHandle = _stateHandle,
+		._valuesHandle = _valuesHandle,
+		._changedEvent = &_changedEvent };
+}
+
+auto ArrayReadState::update(WriteSentinel &writeSentinel,
+	const Descriptor &descriptor,
+	std::chrono::system_clock::time_point timeStamp,
+	std::span<const double> values,
+	const CommonReadState::Changes &commonChanges,
+	bool raiseEvents,
+	PendingEventList &eventsToRaise) -> bool
+{
+	// Get the correct array entries
+	auto &state = writeSentinel[descriptor._stateHandle];
+	const auto &oldState = writeSentinel.oldValues()[descriptor._stateHandle];
+	const std::span<double> newValues = writeSentinel[descriptor._valuesHandle];
+	const std::span<const double> oldValues = writeSentinel.oldValues()[descriptor._valuesHandle];
+
+	// Compare the values in bulk. The values count as changed if any of their bits changed.
+	const auto changed = bool(commonChanges) || std::memcmp(values.data(), oldValues.data(), values.size_bytes()) != 0;
+
+	// Copy the values in bulk. We always need to write the values, even if they are the same as before, because memory
+	// resources use swap-in.
+	std::ranges::copy(values, newValues.begin());
+
+	// Update the change time, if necessary
+	state._changeTime = changed ? timeStamp : oldState._changeTime;
+
+	// Cause the correct events to be raised
+	if (changed && raiseEvents)
+	{
+		eventsToRaise.push_back(*descriptor._changedEvent);
+	}
+
+	return changed;
+}
+
+auto ArrayReadState::keep(WriteSentinel &writeSentinel, const Descriptor &descriptor) -> void
+{
+	// Copy the state and the values without looking at them
+	writeSentinel[descriptor._stateHandle] = writeSentinel.oldValues()[descriptor._stateHandle];
+	const std::span<const double> oldValues = writeSentinel.oldValues()[descriptor._valuesHandle];
+	std::ranges::copy(oldValues, writeSentinel[descriptor._valuesHandle].begin());
+}
+
+auto ArrayReadState::invalidate(WriteSentinel &writeSentinel,
+	const Descriptor &descriptor,
+	std::chrono::system_clock::time_point timeStamp,
+	bool raiseEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Reset the values and the change time
+	std::ranges::fill(writeSentinel[descriptor._valuesHandle], 0.0);
+	writeSentinel[descriptor._stateHandle]._changeTime = timeStamp;
+
+	// The values changed
+	if (raiseEvents)
+	{
+		eventsToRaise.push_back(*descriptor._changedEvent);
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,150 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "Attributes.hpp"
+#include "CommonReadState.hpp"
+#include "DataLayout.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/model/ForEachEventFunction.hpp>
+#include <xentara/process/Event.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <memory>
+#include <span>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief State information for an array of values that is read as a single block.
+///
+/// Unlike PerValueReadState, the whole array shares a single change time and a single changed event. The values are
+/// stored contiguously in the data block, so that they can be updated using a single bulk copy.
+class ArrayReadState final
+{
+private:
+	/// @brief This structure is used to represent the state inside the memory block
+	struct State final
+	{
+		/// @brief The change time stamp
+		std::chrono::system_clock::time_point _changeTime { std::chrono::system_clock::time_point::min() };
+	};
+
+public:
+	/// @brief Everything needed to decode and update the array.
+	struct Descriptor
+	{
+		/// @brief The offset of the first value within the payload of the read command
+		std::size_t _payloadOffset { 0 };
+		/// @brief The number of values
+		std::size_t _length { 0 };
+		/// @brief The array element that contains the state
+		memory::Array::ObjectHandle<State> _stateHandle;
+		/// @brief The array element that contains the values
+		memory::Array::ArrayHandle<double> _valuesHandle;
+		/// @brief The event to raise if any of the values change
+		process::Event *_changedEvent { nullptr };
+	};
+
+	/// @brief Iterates over all the attributes that belong to this state.
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Iterates over all the events that belong to this state.
+	/// @param function The function that should be called for each events
+	/// @param parent
+	/// @parblock
+	/// A shared pointer to the containing object.
+	/// 
+	/// The pointer is used in the aliasing constructor of std::shared_ptr when constructing the event pointers,
+	/// so that they will share ownership information with pointers to the parent object.
+	/// @endparblock
+	/// @return The return value of the last function call
+	auto forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool;
+
+	/// @brief Creates a read-handle for an attribute that belong to this state.
+	/// @note The value attribute is not handled, it must be gotten separately using valueReadHandle().
+	/// @param dataBlock The data block the data is stored in
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown (including the value attribute)
+	auto makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
+		-> std::optional<data::ReadHandle>;
+
+	/// @brief Creates a read-handle for the value attribute
+	/// @param dataBlock The data block the data is stored in
+	/// @return A read handle to the array of values
+	auto valueReadHandle(const DataBlock &dataBlock) const noexcept -> data::ReadHandle;
+
+	/// @brief Attaches the state to its I/O transaction
+	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
+	/// to allocate the data block.
+	/// @param eventCount A variable that counts the total number of events than can be raised for a single update.
+	/// The maximum number of events that update() will request to be raised will be added to this variable. The caller will use this
+	/// event count to preallocate a buffer when collecting the events to raise after an update.
+	/// @param length The number of values in the array
+	/// @param pass The parts of the state to add to the array
+	auto attach(memory::Array &dataArray, std::size_t &eventCount, std::size_t length, AttachPass pass) -> void;
+
+	/// @brief Creates a descriptor for the state
+	/// @param payloadOffset The offset of the first value within the payload of the read command
+	auto descriptor(std::size_t payloadOffset) noexcept -> Descriptor;
+
+	/// @brief Updates the data of an array and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param descriptor The descriptor of the state to update
+	/// @param timeStamp The update time stamp
+	/// @param values The new values. This must contain exactly as many values as the array.
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param raiseEvents Whether to raise the changed event if the values changed
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this
+	/// list. The events will not be raised directly, because the write sentinel needs to be commited first,
+	/// which is done by the caller.
+	/// @return Whether the values changed
+	static auto update(WriteSentinel &writeSentinel,
+		const Descriptor &descriptor,
+		std::chrono::system_clock::time_point timeStamp,
+		std::span<const double> values,
+		const CommonReadState::Changes &commonChanges,
+		bool raiseEvents,
+		PendingEventList &eventsToRaise) -> bool;
+
+	/// @brief Keeps the currently committed data of an array
+	///
+	/// This is used if it is known that none of the values have changed. The data must still be written, because memory
+	/// resources use swap-in.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param descriptor The descriptor of the state to keep
+	static auto keep(WriteSentinel &writeSentinel, const Descriptor &descriptor) -> void;
+
+	/// @brief Resets an array because the data is no longer being acquired, and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param descriptor The descriptor of the state to reset
+	/// @param timeStamp The update time stamp
+	/// @param raiseEvents Whether to raise the changed event
+	/// @param eventsToRaise The changed event will be added to this list, if *raiseEvents* is true.
+	static auto invalidate(WriteSentinel &writeSentinel,
+		const Descriptor &descriptor,
+		std::chrono::system_clock::time_point timeStamp,
+		bool raiseEvents,
+		PendingEventList &eventsToRaise) -> void;
+
+private:
+	/// @brief A summary event that is raised when any of the values change
+	process::Event _changedEvent { io::Direction::Input };
+
+	/// @brief The array element that contains the state
+	memory::Array::ObjectHandle<State> _stateHandle;
+	/// @brief The array element that contains the values
+	memory::Array::ArrayHandle<double> _valuesHandle;
+	/// @brief The number of values
+	std::size_t _length { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
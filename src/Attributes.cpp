@@ -2,12 +2,42 @@
 #include "Attributes.hpp"
 
 #include <xentara/data/DataType.hpp>
+#include <xentara/utils/core/Uuid.hpp>
+
+#include <string_view>
 
 namespace xentara::plugins::templateDriver::attributes
 {
 
+using namespace std::literals;
+using namespace xentara::literals;
+
 const model::Attribute kError { model::Attribute::kError, model::Attribute::Access::ReadOnly, data::DataType::kErrorCode };
 
 const model::Attribute kWriteError { model::Attribute::kWriteError, model::Attribute::Access::ReadOnly, data::DataType::kErrorCode };
 
+/// @todo assign a unique UUID
+const model::Attribute kReadCommandCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readCommandCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadByteCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readByteCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadGapByteCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readGapByteCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kReadCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "readCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kUnchangedReadCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "unchangedReadCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kChangedInputCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "changedInputCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+/// @todo assign a unique UUID
+const model::Attribute kChangedInputs { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "changedInputs"sv, model::Attribute::Access::ReadOnly, data::DataType::kIntegerArray };
+
+/// @todo assign a unique UUID
+const model::Attribute kQueueOverflowCount { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "queueOverflowCount"sv, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
 } // namespace xentara::plugins::templateDriver::attributes
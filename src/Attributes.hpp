@@ -12,4 +12,23 @@ extern const model::Attribute kError;
 /// @brief A Xentara attribute containing a write error code for a data point
 extern const model::Attribute kWriteError;
 
+/// @brief A Xentara attribute containing the number of read commands an I/O transaction sends per read
+extern const model::Attribute kReadCommandCount;
+/// @brief A Xentara attribute containing the number of bytes an I/O transaction reads per read
+extern const model::Attribute kReadByteCount;
+/// @brief A Xentara attribute containing the number of bytes an I/O transaction reads per read that are not needed by any input
+extern const model::Attribute kReadGapByteCount;
+/// @brief A Xentara attribute containing the number of times an I/O transaction has read its inputs
+extern const model::Attribute kReadCount;
+/// @brief A Xentara attribute containing the number of times an I/O transaction has read a payload that was identical to the previous one
+extern const model::Attribute kUnchangedReadCount;
+
+/// @brief A Xentara attribute containing the number of inputs of an I/O transaction that changed during the last update
+extern const model::Attribute kChangedInputCount;
+/// @brief A Xentara attribute containing a bitmap of the inputs of an I/O transaction that changed during the last update
+extern const model::Attribute kChangedInputs;
+
+/// @brief A Xentara attribute containing the number of values that were discarded because an output queue was full
+extern const model::Attribute kQueueOverflowCount;
+
 } // namespace xentara::plugins::templateDriver::attributes
\ No newline at end of file
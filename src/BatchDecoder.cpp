@@ -0,0 +1,267 @@
+// Copyright (c) embedded ocean GmbH
+#include "BatchDecoder.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+// GCC and Clang can compile single functions for instruction sets that the compiler does not target, so the vector
+// implementations are always compiled on x86, and chosen at runtime. Other compilers can only use the instruction sets
+// they target.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#	define TEMPLATE_DRIVER_RUNTIME_DISPATCH 1
+#	define TEMPLATE_DRIVER_VECTOR_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#	define TEMPLATE_DRIVER_HAS_SSE41 1
+#	define TEMPLATE_DRIVER_HAS_AVX2 1
+#	include <immintrin.h>
+#else
+#	define TEMPLATE_DRIVER_VECTOR_TARGET(instructionSet)
+#	if defined(__AVX2__)
+#		define TEMPLATE_DRIVER_HAS_SSE41 1
+#		define TEMPLATE_DRIVER_HAS_AVX2 1
+#		include <immintrin.h>
+#	elif defined(__SSE4_1__)
+#		define TEMPLATE_DRIVER_HAS_SSE41 1
+#		include <smmintrin.h>
+#	endif
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief Decodes values one at a time
+	template <Encoding kEncoding>
+	auto decodeScalar(
+		const std::byte *source, std::size_t count, const double *factors, const double *offsets, double *values) noexcept -> void
+	{
+		constexpr auto kSize = encodedSize(kEncoding, sizeof(double));
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			values[index] = decodeRaw<kEncoding>(source + index * kSize) * factors[index] + offsets[index];
+		}
+	}
+
+#if defined(TEMPLATE_DRIVER_HAS_SSE41)
+
+	/// @brief Returns a shuffle mask that swaps the bytes of each 16-bit or 32-bit lane
+	template <std::size_t kSize>
+	TEMPLATE_DRIVER_VECTOR_TARGET("sse4.1")
+	auto byteSwapMask() noexcept -> __m128i
+	{
+		if constexpr (kSize == 2)
+		{
+			return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+		}
+		else
+		{
+			return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+		}
+	}
+
+	/// @brief Widens byte-swapped raw values to 32-bit signed integers
+	template <Encoding kEncoding>
+	TEMPLATE_DRIVER_VECTOR_TARGET("sse4.1")
+	auto widen(__m128i raw) noexcept -> __m128i
+	{
+		if constexpr (kEncoding == Encoding::Int16BigEndian)
+		{
+			return _mm_cvtepi16_epi32(raw);
+		}
+		else if constexpr (kEncoding == Encoding::UInt16BigEndian)
+		{
+			return _mm_cvtepu16_epi32(raw);
+		}
+		else
+		{
+			return raw;
+		}
+	}
+
+	/// @brief Decodes values two at a time using SSE 4.1, with a scalar loop for the remainder
+	template <Encoding kEncoding>
+	TEMPLATE_DRIVER_VECTOR_TARGET("sse4.1")
+	auto decodeSse41(
+		const std::byte *source, std::size_t count, const double *factors, const double *offsets, double *values) noexcept -> void
+	{
+		constexpr auto kSize = encodedSize(kEncoding, sizeof(double));
+		const auto mask = byteSwapMask<kSize>();
+
+		constexpr std::size_t kLanes = 2;
+		std::size_t index = 0;
+		for (; index + kLanes <= count; index += kLanes)
+		{
+			const auto *data = source + index * kSize;
+			__m128i raw;
+			if constexpr (kSize == 2)
+			{
+				std::int32_t bytes;
+				std::memcpy(&bytes, data, sizeof(bytes));
+				raw = _mm_cvtsi32_si128(bytes);
+			}
+			else
+			{
+				raw = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data));
+			}
+			const auto wide = _mm_cvtepi32_pd(widen<kEncoding>(_mm_shuffle_epi8(raw, mask)));
+			const auto scaled = _mm_add_pd(_mm_mul_pd(wide, _mm_loadu_pd(factors + index)), _mm_loadu_pd(offsets + index));
+			_mm_storeu_pd(values + index, scaled);
+		}
+
+		// Decode the remaining values
+		decodeScalar<kEncoding>(source + index * kSize, count - index, factors + index, offsets + index, values + index);
+	}
+
+#endif
+
+#if defined(TEMPLATE_DRIVER_HAS_AVX2)
+
+	/// @brief Decodes values four at a time using AVX2, with a scalar loop for the remainder
+	template <Encoding kEncoding>
+	TEMPLATE_DRIVER_VECTOR_TARGET("avx2")
+	auto decodeAvx2(
+		const std::byte *source, std::size_t count, const double *factors, const double *offsets, double *values) noexcept -> void
+	{
+		constexpr auto kSize = encodedSize(kEncoding, sizeof(double));
+		const auto mask = byteSwapMask<kSize>();
+
+		constexpr std::size_t kLanes = 4;
+		std::size_t index = 0;
+		for (; index + kLanes <= count; index += kLanes)
+		{
+			const auto *data = source + index * kSize;
+			const auto raw = kSize == 2 ? _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data))
+										: _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+			const auto wide = _mm256_cvtepi32_pd(widen<kEncoding>(_mm_shuffle_epi8(raw, mask)));
+			const auto scaled = _mm256_add_pd(_mm256_mul_pd(wide, _mm256_loadu_pd(factors + index)), _mm256_loadu_pd(offsets + index));
+			_mm256_storeu_pd(values + index, scaled);
+		}
+
+		// Decode the remaining values
+		decodeScalar<kEncoding>(source + index * kSize, count - index, factors + index, offsets + index, values + index);
+	}
+
+#endif
+
+	/// @brief Decodes values using the best of the vector implementations the CPU supports
+	template <Encoding kEncoding>
+	auto decodeVector(InstructionSet instructionSet,
+		const std::byte *source,
+		std::size_t count,
+		const double *factors,
+		const double *offsets,
+		double *values) noexcept -> void
+	{
+		switch (instructionSet)
+		{
+#if defined(TEMPLATE_DRIVER_HAS_AVX2)
+		case InstructionSet::Avx2:
+			decodeAvx2<kEncoding>(source, count, factors, offsets, values);
+			break;
+#endif
+#if defined(TEMPLATE_DRIVER_HAS_SSE41)
+		case InstructionSet::Sse41:
+			decodeSse41<kEncoding>(source, count, factors, offsets, values);
+			break;
+#endif
+		default:
+			decodeScalar<kEncoding>(source, count, factors, offsets, values);
+			break;
+		}
+	}
+
+	/// @brief Asks the CPU which instruction sets it supports
+	auto detectInstructionSet() noexcept -> InstructionSet
+	{
+#if defined(__AVX2__)
+		// The compiler targets AVX2, so the CPU must support it
+		return InstructionSet::Avx2;
+#elif defined(TEMPLATE_DRIVER_RUNTIME_DISPATCH)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return InstructionSet::Avx2;
+		}
+		if (__builtin_cpu_supports("sse4.1"))
+		{
+			return InstructionSet::Sse41;
+		}
+		return InstructionSet::Scalar;
+#elif defined(__SSE4_1__)
+		// The compiler targets SSE 4.1, so the CPU must support it
+		return InstructionSet::Sse41;
+#else
+		return InstructionSet::Scalar;
+#endif
+	}
+
+} // namespace
+
+auto supportedInstructionSet() noexcept -> InstructionSet
+{
+	static const auto instructionSet = detectInstructionSet();
+	return instructionSet;
+}
+
+auto decodeBatch(Encoding encoding,
+	std::span<const std::byte> source,
+	std::span<const double> factors,
+	std::span<const double> offsets,
+	std::span<double> values) noexcept -> void
+{
+	decodeBatch(supportedInstructionSet(), encoding, source, factors, offsets, values);
+}
+
+auto decodeBatch(InstructionSet instructionSet,
+	Encoding encoding,
+	std::span<const std::byte> source,
+	std::span<const double> factors,
+	std::span<const double> offsets,
+	std::span<double> values) noexcept -> void
+{
+	const auto count = values.size();
+
+	switch (encoding)
+	{
+	// These encodings can be widened to 32-bit signed integers, which have vector conversions to double
+	case Encoding::Int16BigEndian:
+		decodeVector<Encoding::Int16BigEndian>(instructionSet, source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::UInt16BigEndian:
+		decodeVector<Encoding::UInt16BigEndian>(instructionSet, source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::Int32BigEndian:
+		decodeVector<Encoding::Int32BigEndian>(instructionSet, source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+
+	// The compiler can usually vectorize these loops on its own, if at all
+	case Encoding::Int8:
+		decodeScalar<Encoding::Int8>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::UInt8:
+		decodeScalar<Encoding::UInt8>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::Int64BigEndian:
+		decodeScalar<Encoding::Int64BigEndian>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::UInt64BigEndian:
+		decodeScalar<Encoding::UInt64BigEndian>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::UInt32BigEndian:
+		decodeScalar<Encoding::UInt32BigEndian>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::Float32BigEndian:
+		decodeScalar<Encoding::Float32BigEndian>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::Float64BigEndian:
+		decodeScalar<Encoding::Float64BigEndian>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	case Encoding::Native:
+	default:
+		decodeScalar<Encoding::Native>(source.data(), count, factors.data(), offsets.data(), values.data());
+		break;
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ValueCodec.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The vector instruction sets decodeBatch() can use
+enum class InstructionSet
+{
+	/// @brief No vector instructions, only a scalar loop
+	Scalar,
+	/// @brief SSE 4.1, which processes two values at once
+	Sse41,
+	/// @brief AVX2, which processes four values at once
+	Avx2,
+};
+
+/// @brief Gets the best instruction set supported by the CPU
+///
+/// The CPU is only queried once. If the compiler already targets AVX2, the CPU is not queried at all.
+auto supportedInstructionSet() noexcept -> InstructionSet;
+
+/// @brief Decodes a contiguous block of values that all have the same encoding
+///
+/// The values are byte-swapped, widened and scaled in a single pass. If the CPU supports AVX2 or SSE 4.1, several
+/// values are processed at once using vector instructions. Otherwise, a scalar loop is used.
+/// @param encoding The encoding of the values
+/// @param source The data to decode. This must contain values.size() values, without gaps.
+/// @param factors The scaling factors, one for each value
+/// @param offsets The scaling offsets, one for each value
+/// @param values Receives the decoded values
+auto decodeBatch(Encoding encoding,
+	std::span<const std::byte> source,
+	std::span<const double> factors,
+	std::span<const double> offsets,
+	std::span<double> values) noexcept -> void;
+
+/// @brief Decodes a contiguous block of values using a specific instruction set
+///
+/// This is used to test each of the vector implementations.
+/// @param instructionSet The instruction set to use. This must not be better than supportedInstructionSet().
+/// @param encoding The encoding of the values
+/// @param source The data to decode. This must contain values.size() values, without gaps.
+/// @param factors The scaling factors, one for each value
+/// @param offsets The scaling offsets, one for each value
+/// @param values Receives the decoded values
+auto decodeBatch(InstructionSet instructionSet,
+	Encoding encoding,
+	std::span<const std::byte> source,
+	std::span<const double> factors,
+	std::span<const double> offsets,
+	std::span<double> values) noexcept -> void;
+
+/// @brief Decodes a contiguous block of values of a type other than double that all have the same encoding
+///
+/// The encoding is resolved once for the whole block, so that the values are converted in a tight scalar loop.
+/// @param encoding The encoding of the values
+/// @param source The data to decode. This must contain values.size() values, without gaps.
+/// @param factors The scaling factors, one for each value
+/// @param offsets The scaling offsets, one for each value
+/// @param values Receives the decoded values
+template <typename DataType>
+auto decodeBatch(Encoding encoding,
+	std::span<const std::byte> source,
+	std::span<const double> factors,
+	std::span<const double> offsets,
+	std::span<DataType> values) noexcept -> void
+{
+	withEncoding(encoding, [&]<Encoding kEncoding>()
+		{
+			constexpr auto kSize = encodedSize(kEncoding, sizeof(DataType));
+			for (std::size_t index = 0; index < values.size(); ++index)
+			{
+				values[index] = decodeValue<DataType, kEncoding>(source.data() + index * kSize, factors[index], offsets[index]);
+			}
+		});
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
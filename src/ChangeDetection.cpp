@@ -0,0 +1,54 @@
+// Copyright (c) embedded ocean GmbH
+#include "ChangeDetection.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX__)
+#	include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#endif
+
+namespace xentara::plugins::templateDriver
+{
+
+auto detectChanges(std::span<const double> previous, std::span<const double> current, std::span<std::uint64_t> mask) noexcept
+	-> void
+{
+	for (std::size_t word = 0; word < mask.size(); ++word)
+	{
+		const auto first = word * kChangeMaskBits;
+		const auto count = std::min(kChangeMaskBits, current.size() - first);
+		const auto *oldValues = previous.data() + first;
+		const auto *newValues = current.data() + first;
+
+		std::uint64_t bits { 0 };
+		std::size_t bit = 0;
+
+#if defined(__AVX__)
+		// Compare four values at a time. Unordered comparison makes NaN compare unequal, just like operator !=.
+		for (; bit + 4 <= count; bit += 4)
+		{
+			const auto unequal = _mm256_cmp_pd(_mm256_loadu_pd(newValues + bit), _mm256_loadu_pd(oldValues + bit), _CMP_NEQ_UQ);
+			bits |= std::uint64_t(_mm256_movemask_pd(unequal)) << bit;
+		}
+#elif defined(__SSE2__) || defined(_M_X64)
+		// Compare two values at a time. _mm_cmpneq_pd() makes NaN compare unequal, just like operator !=.
+		for (; bit + 2 <= count; bit += 2)
+		{
+			const auto unequal = _mm_cmpneq_pd(_mm_loadu_pd(newValues + bit), _mm_loadu_pd(oldValues + bit));
+			bits |= std::uint64_t(_mm_movemask_pd(unequal)) << bit;
+		}
+#endif
+
+		// Compare the remaining values
+		for (; bit < count; ++bit)
+		{
+			bits |= std::uint64_t(newValues[bit] != oldValues[bit]) << bit;
+		}
+
+		mask[word] = bits;
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
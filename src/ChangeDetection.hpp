@@ -0,0 +1,64 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The number of values described by each word of a change mask
+constexpr std::size_t kChangeMaskBits = 64;
+
+/// @brief Gets the number of words a change mask needs to describe a certain number of values
+constexpr auto changeMaskSize(std::size_t valueCount) noexcept -> std::size_t
+{
+	return (valueCount + kChangeMaskBits - 1) / kChangeMaskBits;
+}
+
+/// @brief Checks whether the bit for a value is set in a change mask
+constexpr auto isChanged(std::span<const std::uint64_t> mask, std::size_t index) noexcept -> bool
+{
+	return (mask[index / kChangeMaskBits] >> (index % kChangeMaskBits)) & 1;
+}
+
+/// @brief Sets the bit for a value in a change mask
+constexpr auto markChanged(std::span<std::uint64_t> mask, std::size_t index) noexcept -> void
+{
+	mask[index / kChangeMaskBits] |= std::uint64_t(1) << (index % kChangeMaskBits);
+}
+
+/// @brief Compares two blocks of values and sets a bit in a mask for each value that differs
+///
+/// This generic version uses a branch-free scalar loop.
+/// @param previous The old values
+/// @param current The new values. This must have the same size as *previous*.
+/// @param mask Receives the change mask. This must have changeMaskSize(current.size()) words.
+template <std::regular DataType>
+auto detectChanges(std::span<const DataType> previous, std::span<const DataType> current, std::span<std::uint64_t> mask) noexcept
+	-> void
+{
+	for (std::size_t word = 0; word < mask.size(); ++word)
+	{
+		const auto first = word * kChangeMaskBits;
+		const auto count = std::min(kChangeMaskBits, current.size() - first);
+
+		std::uint64_t bits { 0 };
+		for (std::size_t bit = 0; bit < count; ++bit)
+		{
+			bits |= std::uint64_t(current[first + bit] != previous[first + bit]) << bit;
+		}
+		mask[word] = bits;
+	}
+}
+
+/// @brief Compares two blocks of floating point values and sets a bit in a mask for each value that differs
+///
+/// This overload uses AVX or SSE 2 instructions, if the compiler targets them.
+auto detectChanges(std::span<const double> previous, std::span<const double> current, std::span<std::uint64_t> mask) noexcept
+	-> void;
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
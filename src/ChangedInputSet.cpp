@@ -0,0 +1,97 @@
+// Copyright (c) embedded ocean GmbH
+#include "ChangedInputSet.hpp"
+
+#include "Attributes.hpp"
+#include "ChangeDetection.hpp"
+#include "Events.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <algorithm>
+#include <bit>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto ChangedInputSet::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support
+	return
+		function(attributes::kChangedInputCount) ||
+		function(attributes::kChangedInputs);
+}
+
+auto ChangedInputSet::forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool
+{
+	// Handle all the events we support
+	return
+		function(events::kInputsChanged, std::shared_ptr<process::Event>(parent, &_changedEvent));
+}
+
+auto ChangedInputSet::makeReadHandle(const DataBlock &dataBlock,
+	const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	// Try each readable attribute
+	if (attribute == attributes::kChangedInputCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_changedInputCount);
+	}
+	else if (attribute == attributes::kChangedInputs)
+	{
+		return dataBlock.array(_bitmapHandle);
+	}
+
+	return std::nullopt;
+}
+
+auto ChangedInputSet::attach(memory::Array &dataArray, std::size_t &eventCount, std::size_t inputCount) -> void
+{
+	// Add the state and the bitmap to the array
+	_stateHandle = dataArray.appendObject<State>();
+	_bitmapHandle = dataArray.appendArray<std::uint64_t>(changeMaskSize(inputCount));
+
+	// Preallocate the bitmap used during updates
+	_inputCount = inputCount;
+	_changedInputs.assign(changeMaskSize(inputCount), 0);
+
+	// Add the number of events that can be raised at once, which is just the one event we have.
+	eventCount += 1;
+}
+
+auto ChangedInputSet::reset() noexcept -> std::span<std::uint64_t>
+{
+	std::ranges::fill(_changedInputs, 0);
+	return _changedInputs;
+}
+
+auto ChangedInputSet::markAll() noexcept -> void
+{
+	std::ranges::fill(_changedInputs, ~std::uint64_t(0));
+
+	// Clear the unused bits of the last word, so they are not counted
+	if (const auto usedBits = _inputCount % kChangeMaskBits; usedBits != 0)
+	{
+		_changedInputs.back() = (std::uint64_t(1) << usedBits) - 1;
+	}
+}
+
+auto ChangedInputSet::update(WriteSentinel &writeSentinel, PendingEventList &eventsToRaise) -> void
+{
+	// Copy the bitmap and count the changed inputs. We always need to write the bitmap, even if nothing changed,
+	// because memory resources use swap-in.
+	std::ranges::copy(_changedInputs, writeSentinel[_bitmapHandle].begin());
+	std::uint64_t changedInputCount { 0 };
+	for (auto &&word : _changedInputs)
+	{
+		changedInputCount += std::uint64_t(std::popcount(word));
+	}
+	writeSentinel[_stateHandle]._changedInputCount = changedInputCount;
+
+	// Raise the event if anything changed
+	if (changedInputCount > 0)
+	{
+		eventsToRaise.push_back(_changedEvent);
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
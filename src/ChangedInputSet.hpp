@@ -0,0 +1,99 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "Attributes.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/model/ForEachEventFunction.hpp>
+#include <xentara/process/Event.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The set of inputs of an I/O transaction that changed during the last update.
+///
+/// The set is published as a bitmap in the data block, with one bit for each input. The bits are in the order the inputs
+/// were added to the transaction, which is the order in which the inputs appear in the configuration. Bit 0 of the first
+/// element belongs to the first input. A single event is raised for each update in which any input changed, so that subscribers that
+/// process all the inputs of a transaction in bulk only need to handle one notification per update.
+class ChangedInputSet final
+{
+public:
+	/// @brief Iterates over all the attributes that belong to the set.
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Iterates over all the events that belong to the set.
+	/// @param function The function that should be called for each events
+	/// @param parent
+	/// @parblock
+	/// A shared pointer to the containing object.
+	/// 
+	/// The pointer is used in the aliasing constructor of std::shared_ptr when constructing the event pointers,
+	/// so that they will share ownership information with pointers to the parent object.
+	/// @endparblock
+	/// @return The return value of the last function call
+	auto forEachEvent(const model::ForEachEventFunction &function, std::shared_ptr<void> parent) -> bool;
+
+	/// @brief Creates a read-handle for an attribute that belong to the set.
+	/// @param dataBlock The data block the data is stored in
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown
+	auto makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
+		-> std::optional<data::ReadHandle>;
+
+	/// @brief Attaches the set to its I/O transaction
+	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
+	/// to allocate the data block.
+	/// @param eventCount A variable that counts the total number of events than can be raised for a single update.
+	/// The maximum number of events that update() will request to be raised will be added to this variable.
+	/// @param inputCount The number of inputs of the transaction
+	auto attach(memory::Array &dataArray, std::size_t &eventCount, std::size_t inputCount) -> void;
+
+	/// @brief Clears the set before an update
+	/// @return The bitmap that the changed inputs must be marked in using markChanged()
+	auto reset() noexcept -> std::span<std::uint64_t>;
+
+	/// @brief Marks all the inputs as changed
+	auto markAll() noexcept -> void;
+
+	/// @brief Writes the set to the data block and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param eventsToRaise If any inputs changed, the event will be added to this list.
+	auto update(WriteSentinel &writeSentinel, PendingEventList &eventsToRaise) -> void;
+
+private:
+	/// @brief This structure is used to represent the set inside the memory block
+	struct State final
+	{
+		/// @brief The number of inputs that changed
+		std::uint64_t _changedInputCount { 0 };
+	};
+
+	/// @brief The event that is raised when any of the inputs change
+	process::Event _changedEvent { io::Direction::Input };
+
+	/// @brief The array element that contains the state
+	memory::Array::ObjectHandle<State> _stateHandle;
+	/// @brief The array element that contains the bitmap
+	memory::Array::ArrayHandle<std::uint64_t> _bitmapHandle;
+
+	/// @brief The number of inputs
+	std::size_t _inputCount { 0 };
+	/// @brief A preallocated bitmap that collects the changed inputs during an update
+	std::vector<std::uint64_t> _changedInputs;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/process/Task.hpp>
+#include <xentara/process/ExecutionContext.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief This class providing callbacks for the Xentara scheduler for the "collect" task of I/O transactions
+///
+/// The "collect" task receives the replies to the read commands sent by the "request" task, and updates the inputs.
+template <typename Target>
+class CollectTask final : public process::Task
+{
+public:
+	/// @brief This constuctor attached the task to its target
+	CollectTask(std::reference_wrapper<Target> target) : _target(target)
+	{
+	}
+
+	/// @name Virtual Overrides for process::Task
+	/// @{
+
+	auto stages() const -> Stages final
+	{
+		return Stage::PreOperational | Stage::Operational | Stage::PostOperational;
+	}
+
+	auto preparePreOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto preOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto operational(const process::ExecutionContext &context) -> void final;
+
+	auto preparePostOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto postOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto finishPostOperational(const process::ExecutionContext &context) -> void final;
+		
+	/// @}
+
+private:
+	/// @brief A reference to the target element
+	std::reference_wrapper<Target> _target;
+};
+
+template <typename Target>
+auto CollectTask<Target>::preparePreOperational(const process::ExecutionContext &context) -> Status
+{
+	// Collect the value once to initialize it
+	operational(context);
+
+	// We are done now. Even if we couldn't read the value, we proceed to the next stage,
+	// because attempting again is unlikely to succeed any better.
+	return Status::Ready;
+}
+
+template <typename Target>
+auto CollectTask<Target>::preOperational(const process::ExecutionContext &context) -> Status
+{
+	// We just do the same thing as in the operational stage
+	operational(context);
+
+	return Status::Ready;
+}
+
+template <typename Target>
+auto CollectTask<Target>::operational(const process::ExecutionContext &context) -> void
+{
+	_target.get().performCollectTask(context);
+}
+
+template <typename Target>
+auto CollectTask<Target>::preparePostOperational(const process::ExecutionContext &context) -> Status
+{
+	// Everything in the post operational stage is optional, so we can report ready right away
+	return Status::Ready;
+}
+
+template <typename Target>
+auto CollectTask<Target>::postOperational(const process::ExecutionContext &context) -> Status
+{
+	// We just do the same thing as in the operational stage
+	operational(context);
+
+	return Status::Ready;
+}
+
+template <typename Target>
+auto CollectTask<Target>::finishPostOperational(const process::ExecutionContext &context) -> void
+{
+	// Invalidate the data, since we are no longer acquiring it
+	_target.get().invalidateData(context.scheduledTime());
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
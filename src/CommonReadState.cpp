@@ -6,6 +6,8 @@
 
 #include <xentara/memory/WriteSentinel.hpp>
 
+#include <cassert>
+#include <cstdint>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -68,6 +70,9 @@ auto CommonReadState::update(
 	auto &state = writeSentinel[_stateHandle];
 	const auto &oldState = writeSentinel.oldValues()[_stateHandle];
 
+	// Make sure the data block actually placed the state on a cache line of its own
+	assert(reinterpret_cast<std::uintptr_t>(&state) % alignof(State) == 0);
+
 	state._updateTime = timeStamp;
 
 	// See if the operation was a success
@@ -4,6 +4,7 @@
 #include "Types.hpp"
 #include "Attributes.hpp"
 #include "CustomError.hpp"
+#include "DataLayout.hpp"
 
 #include <xentara/data/Quality.hpp>
 #include <xentara/data/ReadHandle.hpp>
@@ -88,7 +89,10 @@ public:
 
 private:
 	/// @brief This structure is used to represent the state inside the memory block
-	struct State final
+	///
+	/// The state is aligned to a cache line, so that it does not share a cache line with the states of the individual inputs.
+	/// This relies on the data block honouring the alignment of its objects, which update() checks in debug builds.
+	struct alignas(kCacheLineSize) State final
 	{
 		/// @brief The update time stamp
 		std::chrono::system_clock::time_point _updateTime { std::chrono::system_clock::time_point::min() };
@@ -97,6 +101,8 @@ private:
 		/// @brief The error code when reading the value, or a default constructed std::error_code object for none.
 		std::error_code _error { CustomError::NoData };
 	};
+	static_assert(alignof(State) == kCacheLineSize && sizeof(State) % kCacheLineSize == 0,
+		"the common read state must occupy whole cache lines");
 
 	/// @brief A Xentara event that is raised when the inputs were read (sucessfully or not)
 	process::Event _readEvent { io::Direction::Input };
@@ -44,6 +44,12 @@ namespace
 		case CustomError::NoData:
 			return "no data was read yet"s;
 
+		case CustomError::IncompleteData:
+			return "the I/O component returned less data than was requested"s;
+
+		case CustomError::IncompleteWrite:
+			return "the I/O component accepted less data than was written"s;
+
 		/// @todo Add messages for other error codes
 
 		case CustomError::UnknownError:
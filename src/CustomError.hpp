@@ -17,6 +17,12 @@ enum class CustomError
 	/// @brief No data has been read yet.
 	NoData,
 
+	/// @brief The I/O component returned less data than was requested.
+	IncompleteData,
+
+	/// @brief The I/O component accepted less data than was written.
+	IncompleteWrite,
+
 	/// @brief An unknown error occurred
 	UnknownError = 999
 };
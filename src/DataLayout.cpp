@@ -0,0 +1,23 @@
+// Copyright (c) embedded ocean GmbH
+#include "DataLayout.hpp"
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+auto parseDataLayout(std::string_view name) noexcept -> std::optional<DataLayout>
+{
+	if (name == "interleaved"sv)
+	{
+		return DataLayout::Interleaved;
+	}
+	else if (name == "columns"sv)
+	{
+		return DataLayout::Columns;
+	}
+
+	return std::nullopt;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
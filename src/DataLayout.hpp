@@ -0,0 +1,53 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief How the states of the inputs are arranged in the read data block of an I/O transaction
+enum class DataLayout
+{
+	/// @brief The value and change time of each input are stored next to each other
+	Interleaved,
+	/// @brief The values of all inputs are stored contiguously, followed by the change times of all inputs.
+	///
+	/// This means that consumers that scan only the values touch fewer cache lines, and that the values of inputs that
+	/// are read together lie next to each other.
+	Columns
+};
+
+/// @brief Parses the name of a data layout, as used in the configuration
+/// @return The layout, or std::nullopt if the name is unknown
+auto parseDataLayout(std::string_view name) noexcept -> std::optional<DataLayout>;
+
+/// @brief The parts of the state of an input that are added to the data array in a single pass over the inputs
+enum class AttachPass
+{
+	/// @brief All the parts, used with DataLayout::Interleaved
+	All,
+	/// @brief Only the values, used for the first pass with DataLayout::Columns
+	Values,
+	/// @brief Everything except the values, used for the second pass with DataLayout::Columns
+	Metadata
+};
+
+/// @brief Checks whether a pass attaches the values
+constexpr auto attachesValues(AttachPass pass) noexcept -> bool
+{
+	return pass != AttachPass::Metadata;
+}
+
+/// @brief Checks whether a pass attaches everything except the values
+constexpr auto attachesMetadata(AttachPass pass) noexcept -> bool
+{
+	return pass != AttachPass::Values;
+}
+
+/// @brief The size of a cache line, used to keep data that is accessed separately apart
+constexpr std::size_t kCacheLineSize = 64;
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
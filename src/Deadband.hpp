@@ -0,0 +1,69 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A deadband that suppresses small changes of a value.
+///
+/// A new value is only reported if it differs from the last reported value by more than the deadband. Otherwise, the
+/// last reported value is kept, so that neither the change time nor the changed event are updated. The deadband is the
+/// larger of the absolute deadband and the relative deadband multiplied by the magnitude of the last reported value.
+///
+/// The hysteresis is added to the deadband if the value moves in the opposite direction than it did when it last changed.
+/// This prevents values that oscillate around a point from being reported over and over again.
+struct Deadband
+{
+	/// @brief The absolute deadband
+	double _absolute { 0.0 };
+	/// @brief The relative deadband, as a fraction of the magnitude of the last reported value
+	double _relative { 0.0 };
+	/// @brief The hysteresis that applies if the direction of change is reversed
+	double _hysteresis { 0.0 };
+
+	/// @brief Checks whether the deadband lets all changes through
+	constexpr auto isNone() const noexcept -> bool
+	{
+		return _absolute == 0.0 && _relative == 0.0 && _hysteresis == 0.0;
+	}
+
+	/// @brief Filters a new value
+	/// @param reported The last reported value
+	/// @param current The new value
+	/// @param direction The direction of the last reported change, or 0 if the value has not changed yet. This is updated
+	/// if the new value is reported.
+	/// @return *current* if the change must be reported, or *reported* if the change lies within the deadband.
+	template <typename DataType>
+	auto filter(DataType reported, DataType current, std::int8_t &direction) const noexcept -> DataType
+	{
+		// Always report NaN and changes from NaN
+		const auto difference = double(current) - double(reported);
+		if (difference == 0.0 || std::isnan(difference))
+		{
+			return current;
+		}
+
+		// Calculate the deadband, adding the hysteresis if the direction was reversed
+		const std::int8_t newDirection = difference > 0.0 ? 1 : -1;
+		auto threshold = std::max(_absolute, _relative * std::abs(double(reported)));
+		if (direction != 0 && newDirection != direction)
+		{
+			threshold += _hysteresis;
+		}
+
+		// Suppress the change if it lies within the deadband
+		if (std::abs(difference) <= threshold)
+		{
+			return reported;
+		}
+
+		direction = newDirection;
+		return current;
+	}
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,340 @@
+// Copyright (c) embedded ocean GmbH
+#include "DecodeTable.hpp"
+
+#include "BatchDecoder.hpp"
+#include "ChangeDetection.hpp"
+#include "InputSnapshot.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto DecodeTable::addArray(const ArrayReadState::Descriptor &descriptor, Encoding encoding, const Scaling &scaling) -> void
+{
+	_arrays.push_back({ ._descriptor = descriptor, ._encoding = encoding, ._first = _arrayValues.size(), ._inputNumber = _inputNumbers[_inputCount++] });
+	_arrayFactors.resize(_arrayFactors.size() + descriptor._length, scaling._factor);
+	_arrayOffsets.resize(_arrayOffsets.size() + descriptor._length, scaling._offset);
+	_arrayValues.resize(_arrayValues.size() + descriptor._length);
+}
+
+auto DecodeTable::clear() noexcept -> void
+{
+	std::apply([](auto &&...lists) { (lists.clear(), ...); }, _lists);
+	_inputCount = 0;
+
+	_arrays.clear();
+	_arrayFactors.clear();
+	_arrayOffsets.clear();
+	_arrayValues.clear();
+}
+
+auto DecodeTable::keep(WriteSentinel &writeSentinel) -> void
+{
+	std::apply([&](auto &&...lists) { (lists.keep(writeSentinel), ...); }, _lists);
+
+	for (auto &&array : _arrays)
+	{
+		ArrayReadState::keep(writeSentinel, array._descriptor);
+	}
+}
+
+auto DecodeTable::invalidate(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	bool raiseInputEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	std::apply([&](auto &&...lists) { (lists.invalidate(writeSentinel, timeStamp, raiseInputEvents, eventsToRaise), ...); }, _lists);
+
+	for (auto &&array : _arrays)
+	{
+		ArrayReadState::invalidate(writeSentinel, array._descriptor, timeStamp, raiseInputEvents, eventsToRaise);
+	}
+}
+
+auto DecodeTable::decode(
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) noexcept -> void
+{
+	// Decode all the values of each type in one go
+	std::apply([&](auto &&...lists) { (lists.decode(payloadOrError), ...); }, _lists);
+
+	// Decode the arrays
+	decodeArrays(payloadOrError);
+}
+
+auto DecodeTable::update(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const CommonReadState::Changes &commonChanges,
+	std::span<std::uint64_t> changedInputs,
+	bool raiseInputEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Update all the values of each type in one go
+	std::apply([&](auto &&...lists)
+		{ (lists.update(writeSentinel, timeStamp, commonChanges, changedInputs, raiseInputEvents, eventsToRaise), ...); },
+		_lists);
+
+	// Update the arrays
+	updateArrays(writeSentinel, timeStamp, commonChanges, changedInputs, raiseInputEvents, eventsToRaise);
+}
+
+auto DecodeTable::storeValues(std::span<std::byte> cells) const noexcept -> void
+{
+	std::apply([&](auto &&...lists) { (lists.storeValues(cells), ...); }, _lists);
+}
+
+auto DecodeTable::decodeArrays(
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) noexcept -> void
+{
+	// Check if we have a valid payload
+	if (payloadOrError)
+	{
+		// Decode each array in one go
+		const auto data = payloadOrError->get().data();
+		for (auto &&array : _arrays)
+		{
+			const auto &descriptor = array._descriptor;
+			decodeBatch(array._encoding,
+				data.subspan(descriptor._payloadOffset, descriptor._length * encodedSize(array._encoding, sizeof(double))),
+				std::span<const double>(_arrayFactors).subspan(array._first, descriptor._length),
+				std::span<const double>(_arrayOffsets).subspan(array._first, descriptor._length),
+				std::span(_arrayValues).subspan(array._first, descriptor._length));
+		}
+	}
+	// We have an error
+	else
+	{
+		// Replace all the values with zero
+		std::ranges::fill(_arrayValues, 0.0);
+	}
+}
+
+auto DecodeTable::updateArrays(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const CommonReadState::Changes &commonChanges,
+	std::span<std::uint64_t> changedInputs,
+	bool raiseInputEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Update the states
+	for (auto &&array : _arrays)
+	{
+		const auto changed = ArrayReadState::update(writeSentinel,
+			array._descriptor,
+			timeStamp,
+			std::span<const double>(_arrayValues).subspan(array._first, array._descriptor._length),
+			commonChanges,
+			raiseInputEvents,
+			eventsToRaise);
+		if (changed)
+		{
+			markChanged(changedInputs, array._inputNumber);
+		}
+	}
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::ValueBuffer::emplaceBack() -> void
+{
+	// Grow the buffer geometrically, so that adding many values does not take quadratic time
+	if (_size == _capacity)
+	{
+		const auto capacity = std::max(_capacity * 2, std::size_t(16));
+		auto data = std::make_unique<DataType[]>(capacity);
+		std::copy_n(_data.get(), _size, data.get());
+		_data = std::move(data);
+		_capacity = capacity;
+	}
+
+	_data[_size++] = DataType();
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::add(const typename PerValueReadState<DataType>::Descriptor &descriptor,
+	Encoding encoding,
+	const Scaling &scaling,
+	const Deadband &deadband,
+	std::size_t inputNumber) -> void
+{
+	const auto index = _descriptors.size();
+
+	// Only remember the deadband if it actually filters anything, so that values without deadband cost nothing
+	if (!deadband.isNone())
+	{
+		_deadbandIndices.push_back(index);
+		_deadbands.push_back(deadband);
+		_directions.push_back(0);
+	}
+
+	_descriptors.push_back(descriptor);
+	_inputNumbers.push_back(inputNumber);
+	_factors.push_back(scaling._factor);
+	_offsets.push_back(scaling._offset);
+	_values.emplaceBack();
+	_previousValues.emplaceBack();
+	_changeMask.resize(changeMaskSize(_descriptors.size()));
+
+	// Append the value to the last run if it has the same encoding and directly follows it
+	if (!_runs.empty())
+	{
+		auto &run = _runs.back();
+		if (run._encoding == encoding && descriptor._payloadOffset == run._payloadOffset + run._count * encodedSize(encoding, sizeof(DataType)))
+		{
+			++run._count;
+			return;
+		}
+	}
+
+	// Start a new run
+	_runs.push_back({ ._encoding = encoding, ._payloadOffset = descriptor._payloadOffset, ._first = index, ._count = 1 });
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::clear() noexcept -> void
+{
+	_descriptors.clear();
+	_inputNumbers.clear();
+	_runs.clear();
+	_factors.clear();
+	_offsets.clear();
+	_values.clear();
+	_previousValues.clear();
+	_changeMask.clear();
+	_deadbandIndices.clear();
+	_deadbands.clear();
+	_directions.clear();
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::invalidate(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	bool raiseInputEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Reset the states
+	PerValueReadState<DataType>::invalidate(writeSentinel, _descriptors, timeStamp, raiseInputEvents, eventsToRaise);
+
+	// The previous values must match the values in the data block, and the deadbands start over
+	std::ranges::fill(_previousValues.values(), DataType());
+	std::ranges::fill(_directions, 0);
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::applyDeadbands() noexcept -> void
+{
+	const auto values = _values.values();
+	const auto previousValues = std::as_const(_previousValues).values();
+	for (std::size_t entry = 0; entry < _deadbandIndices.size(); ++entry)
+	{
+		const auto index = _deadbandIndices[entry];
+		values[index] = _deadbands[entry].filter(previousValues[index], values[index], _directions[entry]);
+	}
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::decode(
+	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) noexcept -> void
+{
+	// Check if we have a valid payload
+	if (payloadOrError)
+	{
+		// Decode all the values, one run at a time
+		const auto data = payloadOrError->get().data();
+		for (auto &&run : _runs)
+		{
+			decodeBatch(run._encoding,
+				data.subspan(run._payloadOffset, run._count * encodedSize(run._encoding, sizeof(DataType))),
+				std::span<const double>(_factors).subspan(run._first, run._count),
+				std::span<const double>(_offsets).subspan(run._first, run._count),
+				_values.values().subspan(run._first, run._count));
+		}
+
+		// Discard changes that lie within the deadbands. The previous values are the ones that were last reported,
+		// because suppressed values are never written.
+		applyDeadbands();
+	}
+	// We have an error
+	else
+	{
+		// Replace all the values with a default constructed value
+		std::ranges::fill(_values.values(), DataType());
+	}
+
+	// Detect the changes in bulk
+	detectChanges(std::as_const(_previousValues).values(), std::as_const(_values).values(), std::span(_changeMask));
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::update(WriteSentinel &writeSentinel,
+	std::chrono::system_clock::time_point timeStamp,
+	const CommonReadState::Changes &commonChanges,
+	std::span<std::uint64_t> changedInputs,
+	bool raiseInputEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Update the states
+	PerValueReadState<DataType>::update(writeSentinel,
+		_descriptors,
+		timeStamp,
+		std::as_const(_values).values(),
+		_changeMask,
+		commonChanges,
+		raiseInputEvents,
+		eventsToRaise);
+
+	// Mark the inputs that changed in the transaction's bitmap
+	if (commonChanges)
+	{
+		for (auto &&inputNumber : _inputNumbers)
+		{
+			markChanged(changedInputs, inputNumber);
+		}
+	}
+	else
+	{
+		for (std::size_t word = 0; word < _changeMask.size(); ++word)
+		{
+			for (auto bits = _changeMask[word]; bits != 0; bits &= bits - 1)
+			{
+				const auto index = word * kChangeMaskBits + std::size_t(std::countr_zero(bits));
+				markChanged(changedInputs, _inputNumbers[index]);
+			}
+		}
+	}
+
+	// The new values become the previous values. The old buffer will be overwritten on the next update.
+	std::swap(_values, _previousValues);
+}
+
+template <std::regular DataType>
+auto DecodeTable::List<DataType>::storeValues(std::span<std::byte> cells) const noexcept -> void
+{
+	// The previous values always match the values in the data block
+	const auto values = _previousValues.values();
+	for (std::size_t index = 0; index < values.size(); ++index)
+	{
+		std::memcpy(cells.data() + _inputNumbers[index] * InputSnapshot::kCellSize, &values[index], sizeof(DataType));
+	}
+}
+
+/// @class xentara::plugins::templateDriver::DecodeTable::List
+/// @todo add template instantiations for any additional value types
+template class DecodeTable::List<bool>;
+template class DecodeTable::List<std::int8_t>;
+template class DecodeTable::List<std::uint8_t>;
+template class DecodeTable::List<std::int16_t>;
+template class DecodeTable::List<std::uint16_t>;
+template class DecodeTable::List<std::int32_t>;
+template class DecodeTable::List<std::uint32_t>;
+template class DecodeTable::List<std::int64_t>;
+template class DecodeTable::List<std::uint64_t>;
+template class DecodeTable::List<float>;
+template class DecodeTable::List<double>;
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,300 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "ArrayReadState.hpp"
+#include "CommonReadState.hpp"
+#include "Deadband.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+#include "ValueCodec.hpp"
+#include "ValueType.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A flat table of descriptors used to decode the payload of a read command.
+///
+/// The descriptors are grouped by value type, so that all the values of one type can be updated in a single,
+/// devirtualized loop. Within each type, values that have the same encoding and directly follow each other in
+/// the payload are decoded together using decodeBatch(). Values that have a deadband are then filtered, so that changes
+/// within the deadband are discarded. Changes are then detected for all values of a type at once
+/// using detectChanges(), so that only the values that actually changed need to be visited when raising events.
+///
+/// Each input is identified by its number within the I/O transaction, which is taken from the list set using setInputNumbers().
+/// The inputs that changed are marked in a bitmap using these numbers.
+///
+/// Updating is split into two steps. decode() decodes the payload and detects the changes without touching the data block,
+/// so that it can be done before the data block is opened for writing. update() then only copies the results into the data
+/// block, which keeps the time the data block is held for writing as short as possible.
+///
+/// Arrays are kept in a separate list. Each array is decoded using a single call to decodeBatch(), and is then compared
+/// and copied into the data block in bulk.
+class DecodeTable final
+{
+public:
+	/// @brief Sets the numbers of the inputs of the table within its I/O transaction
+	/// @param inputNumbers The numbers of the inputs, in the order they will be added to the table. The numbers are
+	/// copied as the inputs are added, so the span must remain valid until all the inputs have been added.
+	auto setInputNumbers(std::span<const std::size_t> inputNumbers) noexcept -> void
+	{
+		_inputNumbers = inputNumbers;
+	}
+
+	/// @brief Adds a descriptor to the table
+	/// @param descriptor The descriptor of the value's state
+	/// @param encoding The encoding of the value in the payload
+	/// @param scaling The scaling to apply after decoding the value
+	/// @param deadband The deadband used to suppress small changes of the value
+	/// @note The values must be added in order of ascending payload offset, or they cannot be decoded together.
+	template <std::regular DataType>
+	auto add(const typename PerValueReadState<DataType>::Descriptor &descriptor,
+		Encoding encoding,
+		const Scaling &scaling,
+		const Deadband &deadband = {}) -> void
+	{
+		std::get<List<DataType>>(_lists).add(descriptor, encoding, scaling, deadband, _inputNumbers[_inputCount++]);
+	}
+
+	/// @brief Adds the descriptor of an array to the table
+	/// @param descriptor The descriptor of the array's state
+	/// @param encoding The encoding of the array's values in the payload
+	/// @param scaling The scaling to apply after decoding the values
+	auto addArray(const ArrayReadState::Descriptor &descriptor, Encoding encoding, const Scaling &scaling) -> void;
+
+	/// @brief Removes all descriptors
+	auto clear() noexcept -> void;
+
+	/// @brief Keeps the currently committed states of all the values in the table.
+	///
+	/// This is used instead of update() if the payload is known to be identical to the one the current states were decoded
+	/// from. Nothing is decoded or compared, and no events are raised.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	auto keep(WriteSentinel &writeSentinel) -> void;
+
+	/// @brief Resets the states of all the values in the table because the data is no longer being acquired.
+	///
+	/// This is used instead of update() when the data is invalidated. Nothing is decoded or compared, since all the values
+	/// count as changed.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param raiseInputEvents Whether to raise the changed events of the individual inputs
+	/// @param eventsToRaise The changed events will be added to this list, if *raiseInputEvents* is true.
+	auto invalidate(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		bool raiseInputEvents,
+		PendingEventList &eventsToRaise) -> void;
+
+	/// @brief Decodes the values of all the values in the table, and detects which ones changed
+	///
+	/// This does not access the data block. The results are written to the data block by the next call to update().
+	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
+	/// containing a read error.
+	auto decode(const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) noexcept
+		-> void;
+
+	/// @brief Updates the states of all the values in the table with the values decoded by decode(), and collects the events to send
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param timeStamp The update time stamp
+	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param changedInputs A bitmap indexed by the input number within the I/O transaction. The bits of all inputs that changed
+	/// will be set.
+	/// @param raiseInputEvents Whether to raise the changed events of the individual inputs
+	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this
+	/// list. The events will not be raised directly, because the write sentinel needs to be commited first,
+	/// which is done by the caller.
+	auto update(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const CommonReadState::Changes &commonChanges,
+		std::span<std::uint64_t> changedInputs,
+		bool raiseInputEvents,
+		PendingEventList &eventsToRaise) -> void;
+
+	/// @brief Copies the values that are currently in the data block into the cells of an InputSnapshot
+	///
+	/// The values are taken from the buffers of the table, so the data block is not accessed.
+	/// @param cells The cells of the snapshot, as returned by InputSnapshot::cells()
+	auto storeValues(std::span<std::byte> cells) const noexcept -> void;
+
+private:
+	/// @brief The descriptors for a single type
+	template <std::regular DataType>
+	class List final
+	{
+	public:
+		/// @brief Adds a descriptor
+		auto add(const typename PerValueReadState<DataType>::Descriptor &descriptor,
+			Encoding encoding,
+			const Scaling &scaling,
+			const Deadband &deadband,
+			std::size_t inputNumber) -> void;
+
+		/// @brief Removes all descriptors
+		auto clear() noexcept -> void;
+
+		/// @brief Keeps the currently committed states
+		auto keep(WriteSentinel &writeSentinel) -> void
+		{
+			PerValueReadState<DataType>::keep(writeSentinel, _descriptors);
+		}
+
+		/// @brief Resets the states
+		auto invalidate(WriteSentinel &writeSentinel,
+			std::chrono::system_clock::time_point timeStamp,
+			bool raiseInputEvents,
+			PendingEventList &eventsToRaise) -> void;
+
+		/// @brief Decodes the values and detects the changes
+		auto decode(const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) noexcept
+			-> void;
+
+		/// @brief Updates the states with the decoded values
+		auto update(WriteSentinel &writeSentinel,
+			std::chrono::system_clock::time_point timeStamp,
+			const CommonReadState::Changes &commonChanges,
+			std::span<std::uint64_t> changedInputs,
+			bool raiseInputEvents,
+			PendingEventList &eventsToRaise) -> void;
+
+		/// @brief Copies the values that are currently in the data block into the cells of a snapshot
+		auto storeValues(std::span<std::byte> cells) const noexcept -> void;
+
+	private:
+		/// @brief Replaces new values that lie within their deadband with the previous values
+		auto applyDeadbands() noexcept -> void;
+
+		/// @brief A contiguous buffer of values.
+		///
+		/// std::vector cannot be used, because std::vector<bool> packs its elements into bits, and cannot be viewed as a span.
+		class ValueBuffer final
+		{
+		public:
+			/// @brief Appends a default constructed value
+			auto emplaceBack() -> void;
+
+			/// @brief Removes all values
+			auto clear() noexcept -> void
+			{
+				_size = 0;
+			}
+
+			/// @brief Gets the values
+			auto values() noexcept -> std::span<DataType>
+			{
+				return { _data.get(), _size };
+			}
+
+			/// @brief Gets the values
+			auto values() const noexcept -> std::span<const DataType>
+			{
+				return { _data.get(), _size };
+			}
+
+		private:
+			/// @brief The values
+			std::unique_ptr<DataType[]> _data;
+			/// @brief The number of values
+			std::size_t _size { 0 };
+			/// @brief The number of values that fit into _data
+			std::size_t _capacity { 0 };
+		};
+
+		/// @brief A number of values that have the same encoding and directly follow each other in the payload
+		struct Run
+		{
+			/// @brief The encoding of the values
+			Encoding _encoding { Encoding::Native };
+			/// @brief The offset of the first value within the payload
+			std::size_t _payloadOffset { 0 };
+			/// @brief The index of the first value in the lists
+			std::size_t _first { 0 };
+			/// @brief The number of values
+			std::size_t _count { 0 };
+		};
+
+		/// @brief The descriptors
+		std::vector<typename PerValueReadState<DataType>::Descriptor> _descriptors;
+		/// @brief The numbers of the inputs within the I/O transaction, one for each descriptor
+		std::vector<std::size_t> _inputNumbers;
+		/// @brief The runs of values that can be decoded together
+		std::vector<Run> _runs;
+		/// @brief The scaling factors, one for each descriptor
+		std::vector<double> _factors;
+		/// @brief The scaling offsets, one for each descriptor
+		std::vector<double> _offsets;
+		/// @brief A preallocated buffer that receives the decoded values, one for each descriptor
+		ValueBuffer _values;
+		/// @brief The values that were written by the last update, one for each descriptor.
+		///
+		/// These are kept in a contiguous buffer, so that changes can be detected without having to visit
+		/// the individual states in the data block.
+		ValueBuffer _previousValues;
+		/// @brief A preallocated buffer that receives the change mask
+		std::vector<std::uint64_t> _changeMask;
+		/// @brief The indices of the values that have a deadband
+		std::vector<std::size_t> _deadbandIndices;
+		/// @brief The deadbands, one for each entry in _deadbandIndices
+		std::vector<Deadband> _deadbands;
+		/// @brief The direction of the last reported change, one for each entry in _deadbandIndices
+		std::vector<std::int8_t> _directions;
+	};
+
+	/// @brief An array in the table
+	struct ArrayEntry
+	{
+		/// @brief The descriptor
+		ArrayReadState::Descriptor _descriptor;
+		/// @brief The encoding of the values
+		Encoding _encoding { Encoding::Native };
+		/// @brief The index of the first value in the buffers
+		std::size_t _first { 0 };
+		/// @brief The number of the input within the I/O transaction
+		std::size_t _inputNumber { 0 };
+	};
+
+	/// @brief Decodes the arrays
+	auto decodeArrays(const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) noexcept
+		-> void;
+
+	/// @brief Updates the states of the arrays with the decoded values
+	auto updateArrays(WriteSentinel &writeSentinel,
+		std::chrono::system_clock::time_point timeStamp,
+		const CommonReadState::Changes &commonChanges,
+		std::span<std::uint64_t> changedInputs,
+		bool raiseInputEvents,
+		PendingEventList &eventsToRaise) -> void;
+
+	/// @brief The numbers of the inputs within the I/O transaction, in the order they are added
+	std::span<const std::size_t> _inputNumbers;
+	/// @brief The number of inputs added to the table
+	std::size_t _inputCount { 0 };
+
+	/// @brief The descriptors, grouped by type
+	ValueTypeTuple<List> _lists;
+
+	/// @brief The arrays
+	std::vector<ArrayEntry> _arrays;
+	/// @brief The scaling factors for the values of all arrays.
+	///
+	/// These are repeated for each value, so that the arrays can be decoded using the same code as the single values.
+	std::vector<double> _arrayFactors;
+	/// @brief The scaling offsets for the values of all arrays
+	std::vector<double> _arrayOffsets;
+	/// @brief A preallocated buffer that receives the decoded values of all arrays
+	std::vector<double> _arrayValues;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
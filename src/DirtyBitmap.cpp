@@ -0,0 +1,25 @@
+// Copyright (c) embedded ocean GmbH
+#include "DirtyBitmap.hpp"
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto DirtyBitmap::reset(std::size_t size) -> void
+{
+	const auto wordCount = (size + kBits - 1) / kBits;
+	_summarySize = (wordCount + kBits - 1) / kBits;
+
+	// Value-initialize the words, which sets them to 0
+	_words = std::make_unique<std::atomic<std::uint64_t>[]>(wordCount);
+	_summary = std::make_unique<std::atomic<std::uint64_t>[]>(_summarySize);
+}
+
+auto DirtyBitmap::any() const noexcept -> bool
+{
+	return std::any_of(_summary.get(), _summary.get() + _summarySize,
+		[](const auto &words) { return words.load(std::memory_order_relaxed) != 0; });
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,82 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A lock-free set of indices that are marked as dirty
+///
+/// Any number of threads can mark indices as dirty, while a single consumer thread collects them. The bitmap has two
+/// levels: each bit of the summary marks a word of the bitmap as having dirty bits. This way, the consumer only has to
+/// visit the words that actually contain dirty bits, and can tell that nothing is dirty by looking at the summary alone.
+///
+/// An index is always marked in the bitmap before it is marked in the summary, and the consumer always clears the
+/// summary before the bitmap. An index marked while the consumer is running is therefore either collected right away,
+/// or on the next call.
+class DirtyBitmap final
+{
+public:
+	/// @brief Allocates space for a number of indices, and clears all marks.
+	///
+	/// This must not be called while other threads are using the bitmap.
+	auto reset(std::size_t size) -> void;
+
+	/// @brief Marks an index as dirty
+	///
+	/// Any data associated with the index must be published before calling this function, because this function uses
+	/// release semantics.
+	auto mark(std::size_t index) noexcept -> void
+	{
+		_words[index / kBits].fetch_or(bit(index), std::memory_order_release);
+		_summary[index / (kBits * kBits)].fetch_or(bit(index / kBits), std::memory_order_release);
+	}
+
+	/// @brief Checks whether any indices might be marked as dirty
+	auto any() const noexcept -> bool;
+
+	/// @brief Collects and clears all the dirty indices
+	/// @param function A function that is called with each dirty index, in ascending order.
+	template <typename Function>
+	auto collect(Function &&function) noexcept(noexcept(function(std::size_t(0)))) -> void
+	{
+		for (std::size_t summaryIndex = 0; summaryIndex < _summarySize; ++summaryIndex)
+		{
+			// Get and clear the words that contain dirty bits
+			for (auto words = _summary[summaryIndex].exchange(0, std::memory_order_acq_rel); words != 0; words &= words - 1)
+			{
+				const auto wordIndex = summaryIndex * kBits + std::size_t(std::countr_zero(words));
+
+				// Get and clear the dirty bits
+				for (auto bits = _words[wordIndex].exchange(0, std::memory_order_acq_rel); bits != 0; bits &= bits - 1)
+				{
+					function(wordIndex * kBits + std::size_t(std::countr_zero(bits)));
+				}
+			}
+		}
+	}
+
+private:
+	/// @brief The number of bits per word
+	static constexpr std::size_t kBits = 64;
+
+	/// @brief Gets the bit for an index within its word
+	static constexpr auto bit(std::size_t index) noexcept -> std::uint64_t
+	{
+		return std::uint64_t(1) << (index % kBits);
+	}
+
+	/// @brief The bitmap, one bit for each index
+	std::unique_ptr<std::atomic<std::uint64_t>[]> _words;
+	/// @brief The summary, one bit for each word of the bitmap
+	std::unique_ptr<std::atomic<std::uint64_t>[]> _summary;
+	/// @brief The number of words in the summary
+	std::size_t _summarySize { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -17,4 +17,7 @@ const process::Event::Role kRead { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid,
 /// @todo assign a unique UUID
 const process::Event::Role kWritten { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "written"sv };
 
+/// @todo assign a unique UUID
+const process::Event::Role kInputsChanged { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "inputsChanged"sv };
+
 } // namespace xentara::plugins::templateDriver::events
\ No newline at end of file
@@ -11,5 +11,7 @@ namespace xentara::plugins::templateDriver::events
 extern const process::Event::Role kRead;
 /// @brief A Xentara event that is raised when a data point was written
 extern const process::Event::Role kWritten;
+/// @brief A Xentara event that is raised when any of the inputs of an I/O transaction changed
+extern const process::Event::Role kInputsChanged;
 
 } // namespace xentara::plugins::templateDriver::events
\ No newline at end of file
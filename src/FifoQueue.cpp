@@ -0,0 +1,23 @@
+// Copyright (c) embedded ocean GmbH
+#include "FifoQueue.hpp"
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+auto parseQueueOverflowPolicy(std::string_view name) noexcept -> std::optional<QueueOverflowPolicy>
+{
+	if (name == "dropNewest"sv)
+	{
+		return QueueOverflowPolicy::DropNewest;
+	}
+	else if (name == "dropOldest"sv)
+	{
+		return QueueOverflowPolicy::DropOldest;
+	}
+
+	return std::nullopt;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
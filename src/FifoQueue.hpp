@@ -0,0 +1,216 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "DataLayout.hpp"
+
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief What a FifoQueue does when a value is enqueued while the queue is full
+enum class QueueOverflowPolicy
+{
+	/// @brief The new value is discarded
+	DropNewest,
+	/// @brief The oldest value in the queue is discarded to make room for the new one
+	DropOldest
+};
+
+/// @brief Parses the name of an overflow policy, as used in the configuration
+/// @return The policy, or std::nullopt if the name is unknown
+auto parseQueueOverflowPolicy(std::string_view name) noexcept -> std::optional<QueueOverflowPolicy>;
+
+/// @brief A thread-safe, lock-free, bounded queue that keeps all values in the order they were enqueued.
+///
+/// Unlike SingleValueQueue, this queue does not overwrite values that have not been dequeued yet. Any number of
+/// threads can enqueue values. The values are normally dequeued by a single consumer, but producers also dequeue values
+/// to discard them if the overflow policy is QueueOverflowPolicy::DropOldest. If the queue is full, the overflow
+/// policy decides which value is discarded, and the overflow is counted.
+///
+/// The queue is a ring of cells, each of which carries a sequence number that tells producers and consumers whether the
+/// cell is free or holds a value. The storage is allocated once by the constructor, so neither side allocates memory.
+template <typename DataType>
+class FifoQueue final : private utils::tools::Unique
+{
+public:
+	/// @brief the value type
+	using value_type = DataType;
+
+	/// @brief The default capacity
+	static constexpr std::size_t kDefaultCapacity = 16;
+
+	/// @brief Constructor
+	/// @param capacity The minimum number of values the queue can hold. This is rounded up to the next power of two.
+	/// @param overflowPolicy What to do if a value is enqueued while the queue is full
+	explicit FifoQueue(std::size_t capacity = kDefaultCapacity, QueueOverflowPolicy overflowPolicy = QueueOverflowPolicy::DropNewest) :
+		_cells(std::make_unique<Cell[]>(std::bit_ceil(std::max(capacity, std::size_t(1))))),
+		_mask(std::bit_ceil(std::max(capacity, std::size_t(1))) - 1),
+		_overflowPolicy(overflowPolicy)
+	{
+		for (std::size_t index = 0; index <= _mask; ++index)
+		{
+			_cells[index]._sequence.store(index, std::memory_order_relaxed);
+		}
+	}
+
+	/// @brief Enqueues a value.
+	///
+	/// If the queue is full, the overflow is counted, and either this value or the oldest value is discarded,
+	/// depending on the overflow policy.
+	/// @param value The value to place in the queue
+	/// @return true if the value was enqueued, or false if it was discarded.
+	auto enqueue(const value_type &value) noexcept -> bool
+	{
+		while (!tryEnqueue(value))
+		{
+			_overflowCount.fetch_add(1, std::memory_order_relaxed);
+			if (_overflowPolicy == QueueOverflowPolicy::DropNewest)
+			{
+				return false;
+			}
+
+			// Discard the oldest value and try again. Another producer may take the freed cell first, in which case
+			// the overflow is counted again.
+			dequeue();
+		}
+
+		return true;
+	}
+
+	/// @brief Gets the oldest value and removes it from the queue
+	/// @return The value or std::nullopt if the queue is empty
+	auto dequeue() noexcept -> std::optional<value_type>
+	{
+		auto position = _dequeuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			auto &cell = _cells[position & _mask];
+			const auto sequence = cell._sequence.load(std::memory_order_acquire);
+			const auto difference = std::intptr_t(sequence) - std::intptr_t(position + 1);
+
+			// If the cell has been filled, try to claim it
+			if (difference == 0)
+			{
+				if (_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					std::optional<value_type> value { cell._value };
+					// Free the cell for the producer that wraps around to it next
+					cell._sequence.store(position + _mask + 1, std::memory_order_release);
+					return value;
+				}
+			}
+			// If the cell has not been filled yet, the queue is empty
+			else if (difference < 0)
+			{
+				return std::nullopt;
+			}
+			// Another consumer has claimed the cell, so try again with the current position
+			else
+			{
+				position = _dequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// @brief Checks whether the queue might contain values
+	auto empty() const noexcept -> bool
+	{
+		const auto position = _dequeuePosition.load(std::memory_order_relaxed);
+		return _cells[position & _mask]._sequence.load(std::memory_order_acquire) != position + 1;
+	}
+
+	/// @brief Gets the number of values the queue can hold
+	auto capacity() const noexcept -> std::size_t
+	{
+		return _mask + 1;
+	}
+
+	/// @brief Gets the overflow policy
+	auto overflowPolicy() const noexcept -> QueueOverflowPolicy
+	{
+		return _overflowPolicy;
+	}
+
+	/// @brief Gets the number of times a value was enqueued while the queue was full
+	auto overflowCount() const noexcept -> std::uint64_t
+	{
+		return _overflowCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	/// @brief A cell of the ring
+	struct Cell
+	{
+		/// @brief The sequence number. This equals the position of a producer that may fill the cell, or that position
+		/// plus one if the cell holds a value for the consumer at that position.
+		std::atomic<std::size_t> _sequence { 0 };
+		/// @brief The value
+		value_type _value {};
+	};
+
+	/// @brief Tries to enqueue a value
+	/// @return false if the queue is full
+	auto tryEnqueue(const value_type &value) noexcept -> bool
+	{
+		auto position = _enqueuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			auto &cell = _cells[position & _mask];
+			const auto sequence = cell._sequence.load(std::memory_order_acquire);
+			const auto difference = std::intptr_t(sequence) - std::intptr_t(position);
+
+			// If the cell is free, try to claim it
+			if (difference == 0)
+			{
+				if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					cell._value = value;
+					// Hand the cell to the consumer
+					cell._sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			// If the cell still holds a value from the previous round, the queue is full
+			else if (difference < 0)
+			{
+				return false;
+			}
+			// Another producer has claimed the cell, so try again with the current position
+			else
+			{
+				position = _enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// The queue stores copies of the values in preallocated cells
+	static_assert(std::is_trivially_copyable_v<value_type>);
+
+	/// @brief The cells
+	std::unique_ptr<Cell[]> _cells;
+	/// @brief The mask used to wrap positions into the ring
+	std::size_t _mask { 0 };
+	/// @brief What to do if the queue is full
+	QueueOverflowPolicy _overflowPolicy { QueueOverflowPolicy::DropNewest };
+
+	/// @brief The position of the next value to enqueue.
+	/// @note This is aligned to a cache line to avoid false sharing between producers and the consumer
+	alignas(kCacheLineSize) std::atomic<std::size_t> _enqueuePosition { 0 };
+	/// @brief The position of the next value to dequeue
+	alignas(kCacheLineSize) std::atomic<std::size_t> _dequeuePosition { 0 };
+	/// @brief The number of overflows
+	alignas(kCacheLineSize) std::atomic<std::uint64_t> _overflowCount { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
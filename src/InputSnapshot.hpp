@@ -0,0 +1,109 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "VersionedBuffer.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A consistent copy of the values of all the inputs of an I/O transaction, taken from a VersionedBuffer
+///
+/// Each version starts with a header holding the update time and the read error, followed by a cell for each input.
+/// The cells are indexed by the number of the input within the I/O transaction, which is the order in which the inputs
+/// appear in the configuration, just like the bits of the bitmap of changed inputs. Each cell holds the value in its own
+/// type, and is large enough for any of the supported value types. The cells of array inputs are always zero, because
+/// arrays are only published through the data block.
+///
+/// The version stays pinned for as long as the snapshot exists, so snapshots should not be kept longer than necessary.
+class InputSnapshot final
+{
+public:
+	/// @brief The size of the cell of each input
+	static constexpr std::size_t kCellSize = sizeof(std::uint64_t);
+
+	/// @brief Gets the size of the data of a snapshot
+	/// @param inputCount The number of inputs of the I/O transaction
+	static constexpr auto size(std::size_t inputCount) noexcept -> std::size_t
+	{
+		return kCellsOffset + inputCount * kCellSize;
+	}
+
+	/// @brief Writes the header of a new version
+	/// @param data The data of the version, as returned by VersionedBuffer::beginWrite()
+	/// @param updateTime The update time
+	/// @param error The read error, or a default constructed std::error_code object if the data was read successfully.
+	static auto writeHeader(std::span<std::byte> data, std::chrono::system_clock::time_point updateTime, std::error_code error) noexcept
+		-> void
+	{
+		const Header header { ._updateTime = updateTime, ._error = error };
+		std::memcpy(data.data(), &header, sizeof(header));
+	}
+
+	/// @brief Gets the cells of a new version
+	/// @param data The data of the version, as returned by VersionedBuffer::beginWrite()
+	static auto cells(std::span<std::byte> data) noexcept -> std::span<std::byte>
+	{
+		return data.subspan(kCellsOffset);
+	}
+
+	/// @brief Creates a snapshot of the version pinned by a reader
+	explicit InputSnapshot(VersionedBuffer::Reader reader) noexcept : _reader(std::move(reader))
+	{
+		std::memcpy(&_header, _reader.data().data(), sizeof(_header));
+	}
+
+	/// @brief Gets the time the inputs were last updated
+	auto updateTime() const noexcept -> std::chrono::system_clock::time_point
+	{
+		return _header._updateTime;
+	}
+
+	/// @brief Gets the read error, or a default constructed std::error_code object if the data was read successfully.
+	auto error() const noexcept -> std::error_code
+	{
+		return _header._error;
+	}
+
+	/// @brief Gets the value of an input
+	/// @tparam DataType The value type of the input
+	/// @param inputNumber The number of the input within its I/O transaction
+	template <typename DataType>
+	auto value(std::size_t inputNumber) const noexcept -> DataType
+	{
+		static_assert(std::is_trivially_copyable_v<DataType> && sizeof(DataType) <= kCellSize);
+
+		DataType value;
+		std::memcpy(&value, _reader.data().data() + kCellsOffset + inputNumber * kCellSize, sizeof(value));
+		return value;
+	}
+
+private:
+	/// @brief The header at the start of each version
+	struct Header final
+	{
+		/// @brief The update time
+		std::chrono::system_clock::time_point _updateTime;
+		/// @brief The read error
+		std::error_code _error;
+	};
+	static_assert(std::is_trivially_copyable_v<Header>);
+
+	/// @brief The offset of the first cell, which is the size of the header rounded up to a whole cell
+	static constexpr std::size_t kCellsOffset = (sizeof(Header) + kCellSize - 1) / kCellSize * kCellSize;
+
+	/// @brief The reader that pins the version
+	VersionedBuffer::Reader _reader;
+	/// @brief A copy of the header
+	Header _header;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,458 @@
+// Copyright (c) embedded ocean GmbH
+#include "IoHandle.hpp"
+
+#include "CustomError.hpp"
+
+#if defined(__linux__)
+#	include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+
+namespace xentara::plugins::templateDriver
+{
+
+#if defined(__linux__)
+namespace
+{
+
+	/// @brief The user data used for the operation that cancels all operations still in flight
+	constexpr std::uint64_t kCancelUserData = 0;
+
+	/// @brief Gets the user data that identifies the operation of a command in the ring
+	template <typename Command>
+	auto userData(const Command &command) noexcept -> std::uint64_t
+	{
+		return std::uint64_t(reinterpret_cast<std::uintptr_t>(&command));
+	}
+
+} // namespace
+
+auto IoHandle::open(int fileDescriptor, unsigned queueDepth, std::chrono::nanoseconds timeout) -> void
+{
+	// Create the ring first, so that we don't take ownership of the file descriptor if this fails
+	_ring = std::make_unique<IoRing>(queueDepth);
+	_fileDescriptor = fileDescriptor;
+
+	// Reserve space for stashed completions. The completion queue has twice as many entries as the submission queue,
+	// so we allow as many operations to be outstanding.
+	_maxOutstanding = std::size_t(queueDepth) * 2;
+	_stashedCompletions.clear();
+	_stashedCompletions.reserve(_maxOutstanding);
+	_abandoned.clear();
+	_abandoned.reserve(_maxOutstanding);
+	_inFlight = 0;
+	_timeout = timeout;
+}
+#endif
+
+auto IoHandle::close() noexcept -> void
+{
+#if defined(__linux__)
+	if (_ring)
+	{
+		// Cancel all operations still in flight and wait for them to complete, so that the kernel doesn't access
+		// the receive buffers anymore after they have been released.
+		const auto outstanding = [&] { return _inFlight > 0 || !_abandoned.empty(); };
+		if (outstanding() && _ring->prepareCancelAll(kCancelUserData) && _ring->submit())
+		{
+			while (outstanding() && _ring->waitForCompletions(std::nullopt))
+			{
+				reapCompletions();
+			}
+		}
+
+		_ring.reset();
+	}
+	_stashedCompletions.clear();
+	_abandoned.clear();
+
+	// Close the file descriptor
+	if (_fileDescriptor >= 0)
+	{
+		::close(_fileDescriptor);
+		_fileDescriptor = -1;
+	}
+#else
+	/// @todo close the handle to the I/O device
+#endif
+}
+
+auto IoHandle::registerReceiveBuffer([[maybe_unused]] std::span<std::byte> buffer) noexcept -> void
+{
+	// This does nothing yet: the reads use plain IORING_OP_READ, which maps the buffer on every read.
+	/// @todo register the buffer with the I/O component, if it supports this. Some I/O APIs allow buffers to be
+	/// registered in advance, so that they do not need to be mapped or pinned on every read.
+}
+
+auto IoHandle::read(ReadCommand &command) const noexcept
+	-> utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>
+{
+	/// @todo if the I/O component supports a combined request/reply operation that is more efficient than
+	/// sending and receiving separately, use that instead.
+
+	// Send the command
+	if (const auto result = sendRead(command); !result)
+	{
+		return utils::eh::unexpected(result.error());
+	}
+
+	// Receive the reply
+	return receiveRead(command);
+}
+
+auto IoHandle::sendRead(const ReadCommand &command) const noexcept -> utils::eh::expected<void, std::error_code>
+{
+#if defined(__linux__)
+	std::unique_lock lock(_ringMutex);
+
+	// Make sure the handle is open
+	if (!_ring)
+	{
+		return utils::eh::unexpected(std::make_error_code(std::errc::not_connected));
+	}
+
+	// Make sure the completion will fit into the stash
+	if (!canStartOperation())
+	{
+		return utils::eh::unexpected(std::make_error_code(std::errc::resource_unavailable_try_again));
+	}
+
+	// A command only ever has one read in flight, so any completion still stashed for it is stale. Purge it, so that
+	// it cannot be mistaken for the reply to this read.
+	std::erase_if(_stashedCompletions, [&](const auto &completion) { return completion._userData == userData(command); });
+
+	/// @todo if the I/O component expects a request before it sends the data, queue a write of the encoded
+	/// request first, and link the two operations using IOSQE_IO_LINK.
+
+	// Queue a read directly into the receive buffer of the command
+	if (!_ring->prepareRead(_fileDescriptor, command.receiveBuffer(), userData(command)))
+	{
+		return utils::eh::unexpected(std::make_error_code(std::errc::resource_unavailable_try_again));
+	}
+	++_inFlight;
+
+	// If the read could not be submitted, it is still queued, and would be submitted along with the next operation.
+	// Withdraw it, so that the caller does not have to deal with a read that failed but is still in flight.
+	if (const auto result = _ring->submit(); !result)
+	{
+		_ring->withdrawUnsubmitted();
+		--_inFlight;
+		return result;
+	}
+
+	return {};
+#else
+	/// @todo send the command to the I/O component
+
+	/// @todo return utils::eh::unexpected(error) if the command could not be sent. Do not throw exceptions.
+
+	return {};
+#endif
+}
+
+auto IoHandle::receiveRead(ReadCommand &command) const noexcept
+	-> utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>
+{
+#if defined(__linux__)
+	// Wait for the read to complete
+	const auto result = waitForCompletion(userData(command));
+	if (!result)
+	{
+		return utils::eh::unexpected(result.error());
+	}
+	// Negative results are negated errno values
+	if (*result < 0)
+	{
+		return utils::eh::unexpected(std::error_code(-*result, std::system_category()));
+	}
+	/// @todo if the I/O component can deliver the data in several parts, queue a read for the rest instead
+	if (std::size_t(*result) < command.size())
+	{
+		return utils::eh::unexpected(std::error_code(CustomError::IncompleteData));
+	}
+#else
+	/// @todo receive the reply from the I/O component directly into command.receiveBuffer()
+
+	/// @todo return utils::eh::unexpected(error) if the reply could not be received, or if the I/O component
+	/// returned an error. Do not throw exceptions.
+#endif
+
+	// Make the received data the new payload
+	return std::cref(command.completeReceive());
+}
+
+auto IoHandle::cancelRead(const ReadCommand &command) const noexcept -> void
+{
+#if defined(__linux__)
+	discard(userData(command));
+#else
+	/// @todo discard the reply to the command, if the I/O component sends one
+#endif
+}
+
+#if defined(__linux__)
+auto IoHandle::discard(std::uint64_t userData) const noexcept -> void
+{
+	std::unique_lock lock(_ringMutex);
+
+	// Make sure the handle is open
+	if (!_ring)
+	{
+		return;
+	}
+
+	// Ask the kernel to cancel the operation. If the operation has already completed, the cancellation simply fails.
+	// If the cancellation cannot be submitted, stop tracking the operation.
+	if (!requestCancel(userData))
+	{
+		abandon(userData);
+		return;
+	}
+
+	// Wait for the operation itself to complete. Its result is of no interest.
+	if (const auto result = awaitCompletion(lock, userData, std::chrono::steady_clock::now() + _timeout); !result)
+	{
+		abandon(userData);
+	}
+}
+
+auto IoHandle::canStartOperation() const noexcept -> bool
+{
+	return _inFlight + _stashedCompletions.size() + _abandoned.size() < _maxOutstanding;
+}
+
+auto IoHandle::waitForCompletion(std::uint64_t userData) const noexcept
+	-> utils::eh::expected<std::int32_t, std::error_code>
+{
+	std::unique_lock lock(_ringMutex);
+
+	// Make sure the handle is open
+	if (!_ring)
+	{
+		return utils::eh::unexpected(std::make_error_code(std::errc::not_connected));
+	}
+
+	// Wait for the operation to complete
+	const auto result = awaitCompletion(lock, userData, std::chrono::steady_clock::now() + _timeout);
+	if (result)
+	{
+		return result;
+	}
+	// If the ring failed, we cannot wait for the operation any more
+	if (result.error() != std::errc::timed_out)
+	{
+		abandon(userData);
+		return result;
+	}
+
+	// The I/O component did not answer in time. Cancel the operation, and wait for the cancellation to take effect,
+	// so that the kernel no longer accesses the buffer of the command.
+	const auto timedOut = utils::eh::unexpected(std::make_error_code(std::errc::timed_out));
+	if (!requestCancel(userData))
+	{
+		abandon(userData);
+		return timedOut;
+	}
+	const auto cancelled = awaitCompletion(lock, userData, std::chrono::steady_clock::now() + _timeout);
+	if (!cancelled)
+	{
+		abandon(userData);
+		return timedOut;
+	}
+
+	// The operation may have completed after all, just before the cancellation reached it
+	if (*cancelled == -ECANCELED)
+	{
+		return timedOut;
+	}
+	return cancelled;
+}
+
+auto IoHandle::awaitCompletion(std::unique_lock<std::mutex> &lock,
+	std::uint64_t userData,
+	std::chrono::steady_clock::time_point deadline) const noexcept -> utils::eh::expected<std::int32_t, std::error_code>
+{
+	for (;;)
+	{
+		// Check if the completion has already been collected
+		if (const auto result = takeStashed(userData))
+		{
+			return *result;
+		}
+
+		// Check if we have run out of time
+		const auto now = std::chrono::steady_clock::now();
+		if (now >= deadline)
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::timed_out));
+		}
+
+		// If another thread is already waiting on the ring, wait for it to collect the completions
+		if (_waitingOnRing)
+		{
+			_completionsCollected.wait_until(lock, deadline);
+			continue;
+		}
+
+		// Wait on the ring ourselves. The lock is released while waiting, so that other threads can send commands.
+		_waitingOnRing = true;
+		lock.unlock();
+		const auto waited = _ring->waitForCompletions(deadline - now);
+		lock.lock();
+		_waitingOnRing = false;
+
+		// Collect the completions, and wake up the other waiting threads, so that they can look for theirs, and one of them
+		// can take over waiting on the ring
+		reapCompletions();
+		_completionsCollected.notify_all();
+
+		if (!waited)
+		{
+			return utils::eh::unexpected(waited.error());
+		}
+	}
+}
+
+auto IoHandle::takeStashed(std::uint64_t userData) const noexcept -> std::optional<std::int32_t>
+{
+	const auto stashed = std::ranges::find(_stashedCompletions, userData, &IoRing::Completion::_userData);
+	if (stashed == _stashedCompletions.end())
+	{
+		return std::nullopt;
+	}
+
+	const auto result = stashed->_result;
+	*stashed = _stashedCompletions.back();
+	_stashedCompletions.pop_back();
+	return result;
+}
+
+auto IoHandle::reapCompletions() const noexcept -> void
+{
+	while (const auto completion = _ring->peekCompletion())
+	{
+		// Cancel operations are not counted as in flight, and nobody waits for them
+		if (completion->_userData == kCancelUserData)
+		{
+			continue;
+		}
+
+		// Drop the completions of abandoned operations. These no longer count as in flight.
+		if (const auto abandoned = std::ranges::find(_abandoned, completion->_userData); abandoned != _abandoned.end())
+		{
+			*abandoned = _abandoned.back();
+			_abandoned.pop_back();
+			continue;
+		}
+
+		// This never allocates, because canStartOperation() keeps the number of outstanding operations within the reserved space
+		--_inFlight;
+		_stashedCompletions.push_back(*completion);
+	}
+}
+
+auto IoHandle::requestCancel(std::uint64_t userData) const noexcept -> bool
+{
+	// If the submission queue is full, submit the queued operations first to make room
+	const auto queued = _ring->prepareCancel(userData, kCancelUserData) ||
+		(_ring->submit() && _ring->prepareCancel(userData, kCancelUserData));
+	if (!queued)
+	{
+		return false;
+	}
+
+	// Don't leave the cancellation queued if it cannot be submitted
+	if (!_ring->submit())
+	{
+		_ring->withdrawUnsubmitted();
+		return false;
+	}
+
+	return true;
+}
+
+auto IoHandle::abandon(std::uint64_t userData) const noexcept -> void
+{
+	// The operation may have completed in the meantime
+	reapCompletions();
+	if (takeStashed(userData))
+	{
+		return;
+	}
+
+	// Try to cancel the operation, so that it does not stay in flight forever, and drop its completion once it arrives.
+	// This never allocates, because the operation was counted as outstanding by canStartOperation().
+	static_cast<void>(requestCancel(userData));
+	--_inFlight;
+	_abandoned.push_back(userData);
+}
+#endif
+
+auto IoHandle::write(const WriteCommand &command) const noexcept -> utils::eh::expected<void, std::error_code>
+{
+#if defined(__linux__)
+	{
+		std::scoped_lock lock(_ringMutex);
+
+		// Make sure the handle is open
+		if (!_ring)
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::not_connected));
+		}
+
+		// Make sure the completion will fit into the stash
+		if (!canStartOperation())
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::resource_unavailable_try_again));
+		}
+
+		/// @todo if the I/O component expects a header containing the address in front of the data, queue a write of the
+		/// header first, and link the two operations using IOSQE_IO_LINK.
+
+		// Queue a write directly from the command data
+		if (!_ring->prepareWrite(_fileDescriptor, command.data(), userData(command)))
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::resource_unavailable_try_again));
+		}
+		++_inFlight;
+
+		// If the write could not be submitted, withdraw it, so that the kernel does not access the data of the command
+		// after it has gone out of scope
+		if (const auto result = _ring->submit(); !result)
+		{
+			_ring->withdrawUnsubmitted();
+			--_inFlight;
+			return result;
+		}
+	}
+
+	// Wait for the write to complete
+	const auto result = waitForCompletion(userData(command));
+	if (!result)
+	{
+		return utils::eh::unexpected(result.error());
+	}
+	// Negative results are negated errno values
+	if (*result < 0)
+	{
+		return utils::eh::unexpected(std::error_code(-*result, std::system_category()));
+	}
+	if (std::size_t(*result) < command.data().size())
+	{
+		return utils::eh::unexpected(std::error_code(CustomError::IncompleteWrite));
+	}
+#else
+	/// @todo send the command to the I/O component
+
+	/// @todo return utils::eh::unexpected(error) if the command could not be sent, or if the I/O component
+	/// returned an error. Do not throw exceptions.
+#endif
+
+	return {};
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
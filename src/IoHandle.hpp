@@ -0,0 +1,183 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "IoRing.hpp"
+#include "ReadCommand.hpp"
+#include "WriteCommand.hpp"
+
+#include <xentara/utils/eh/expected.hpp>
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A handle used to access the I/O component
+///
+/// The functions of the handle report errors using return values rather than exceptions. This way, an I/O component
+/// that is offline costs about as much to poll as one that is online, instead of throwing on every cycle.
+///
+/// Under Linux, the handle uses io_uring to access a file descriptor representing the I/O component. Read commands
+/// from many I/O transactions can be in flight at the same time: each read is queued by sendRead(), and its completion
+/// is handed back to the transaction that sent it by receiveRead(). Completions that arrive for other commands are kept
+/// until their transaction collects them.
+///
+/// Only one thread waits on the ring at a time, and it does so without holding the lock that protects the ring, so that
+/// other transactions can send commands in the meantime. The other waiting threads sleep until the waiting thread has
+/// collected the completions that arrived, and one of them takes over waiting on the ring once it is done. An operation that
+/// does not complete within the response timeout is cancelled, and reported as std::errc::timed_out.
+/// @todo implement a proper handle
+class IoHandle final : private utils::tools::Unique
+{
+public:
+	/// @brief The default maximum time to wait for a command to complete
+	static constexpr std::chrono::nanoseconds kDefaultTimeout = std::chrono::seconds(1);
+
+#if defined(__linux__)
+	/// @brief Opens the handle
+	/// @param fileDescriptor A file descriptor for the I/O component, e.g. a device node, pipe or socket.
+	/// The handle takes ownership of the file descriptor.
+	/// @param queueDepth The maximum number of commands that can be in flight at the same time
+	/// @param timeout The maximum time to wait for a command to complete
+	/// @throw std::system_error The handle could not be opened
+	auto open(int fileDescriptor, unsigned queueDepth, std::chrono::nanoseconds timeout = kDefaultTimeout) -> void;
+#endif
+
+	/// @brief Closes the handle
+	///
+	/// Any commands still in flight are cancelled.
+	auto close() noexcept -> void;
+
+	/// @brief Registers a buffer that data will be received into
+	///
+	/// This is called once for each receive buffer when the I/O transactions are prepared, so that the I/O component
+	/// can receive data directly into the buffer without copying it.
+	///
+	/// This is currently a no-op: the buffers are not registered with the ring, and each read passes its buffer to the
+	/// kernel directly.
+	/// @param buffer The buffer. The buffer remains valid until the I/O component is cleaned up.
+	auto registerReceiveBuffer(std::span<std::byte> buffer) noexcept -> void;
+
+	/// @brief Sends a read command and receives the data
+	///
+	/// This is equivalent to calling sendRead() followed by receiveRead().
+	/// @param command The command to send. The data will be received directly into the command's receive buffer.
+	/// @return The payload of the command, or the error that occurred
+	auto read(ReadCommand &command) const noexcept
+		-> utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>;
+
+	/// @brief Sends a read command without waiting for the reply
+	///
+	/// If an error is returned, the read is not in flight, and neither receiveRead() nor cancelRead() must be called.
+	/// @param command The command to send
+	/// @return Nothing, or the error that occurred
+	auto sendRead(const ReadCommand &command) const noexcept -> utils::eh::expected<void, std::error_code>;
+
+	/// @brief Cancels a read command previously sent using sendRead() whose reply will not be received
+	///
+	/// This waits until the read is no longer in flight, so that the kernel no longer writes into the command's receive buffer,
+	/// and its completion cannot be mistaken for the reply to the next read of the same command.
+	/// @param command The command that was sent
+	auto cancelRead(const ReadCommand &command) const noexcept -> void;
+
+	/// @brief Receives the reply to a read command previously sent using sendRead()
+	///
+	/// The read is no longer in flight when this function returns, even if an error is returned, unless the ring itself failed.
+	/// @param command The command that was sent. The data will be received directly into the command's receive buffer.
+	/// @return The payload of the command, or the error that occurred
+	auto receiveRead(ReadCommand &command) const noexcept
+		-> utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>;
+
+	/// @brief Sends a write command
+	/// @param command The command to send
+	/// @return Nothing, or the error that occurred
+	auto write(const WriteCommand &command) const noexcept -> utils::eh::expected<void, std::error_code>;
+
+#if defined(__linux__)
+private:
+	/// @brief Waits for the completion of an operation, and cancels the operation if it does not complete in time
+	///
+	/// The operation is no longer in flight when this function returns, even if an error is returned.
+	/// @param userData The user data of the operation
+	/// @return The result of the operation, or the error that occurred
+	auto waitForCompletion(std::uint64_t userData) const noexcept -> utils::eh::expected<std::int32_t, std::error_code>;
+
+	/// @brief Waits for the completion of an operation until a deadline
+	///
+	/// The lock is released while waiting.
+	/// @param lock The lock on _ringMutex
+	/// @param userData The user data of the operation
+	/// @param deadline The time at which to stop waiting
+	/// @return The result of the operation, std::errc::timed_out if the deadline has passed, or the error that occurred
+	auto awaitCompletion(std::unique_lock<std::mutex> &lock, std::uint64_t userData, std::chrono::steady_clock::time_point deadline)
+		const noexcept -> utils::eh::expected<std::int32_t, std::error_code>;
+
+	/// @brief Takes the completion of an operation from the stash, if it has arrived
+	/// @note The caller must hold _ringMutex.
+	auto takeStashed(std::uint64_t userData) const noexcept -> std::optional<std::int32_t>;
+
+	/// @brief Moves all the completions that have arrived from the ring into the stash
+	/// @note The caller must hold _ringMutex.
+	auto reapCompletions() const noexcept -> void;
+
+	/// @brief Asks the kernel to cancel an operation
+	/// @note The caller must hold _ringMutex.
+	/// @return Whether the cancellation was submitted
+	auto requestCancel(std::uint64_t userData) const noexcept -> bool;
+
+	/// @brief Stops tracking an operation whose completion cannot be waited for
+	///
+	/// The operation is cancelled if possible, and no longer counts as in flight. Its completion is dropped when it arrives.
+	/// @note The caller must hold _ringMutex.
+	auto abandon(std::uint64_t userData) const noexcept -> void;
+
+	/// @brief Checks whether another operation may be started
+	///
+	/// The number of operations that are in flight, abandoned, or whose completions are stashed is limited, so that the stash
+	/// and the list of abandoned operations never grow beyond the space reserved for them.
+	/// @note The caller must hold _ringMutex.
+	auto canStartOperation() const noexcept -> bool;
+
+	/// @brief Cancels an operation and waits for it to complete, discarding its result
+	/// @param userData The user data of the operation
+	auto discard(std::uint64_t userData) const noexcept -> void;
+
+	/// @brief The file descriptor for the I/O component
+	int _fileDescriptor { -1 };
+	/// @brief The ring used to perform asynchronous I/O
+	std::unique_ptr<IoRing> _ring;
+	/// @brief The maximum time to wait for an operation to complete
+	std::chrono::nanoseconds _timeout { kDefaultTimeout };
+	/// @brief Protects access to the ring, which is shared by all I/O transactions
+	mutable std::mutex _ringMutex;
+	/// @brief Signalled whenever the thread waiting on the ring has collected new completions
+	mutable std::condition_variable _completionsCollected;
+	/// @brief Whether a thread is currently waiting on the ring
+	mutable bool _waitingOnRing { false };
+	/// @brief Completions that arrived while waiting for another operation.
+	///
+	/// Space for these is reserved when the handle is opened, so that no memory is allocated while reading.
+	mutable std::vector<IoRing::Completion> _stashedCompletions;
+	/// @brief The number of operations whose completions have not been taken from the ring yet
+	mutable std::size_t _inFlight { 0 };
+	/// @brief The user data of operations that were abandoned, and whose completions must be dropped when they arrive.
+	///
+	/// Space for these is reserved when the handle is opened, just like for the stashed completions.
+	mutable std::vector<std::uint64_t> _abandoned;
+	/// @brief The maximum number of operations that may be in flight or stashed at the same time
+	std::size_t _maxOutstanding { 0 };
+#endif
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
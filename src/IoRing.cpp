@@ -0,0 +1,309 @@
+// Copyright (c) embedded ocean GmbH
+#include "IoRing.hpp"
+
+#if defined(__linux__)
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+namespace xentara::plugins::templateDriver
+{
+
+namespace
+{
+
+	/// @brief Maps a part of the ring into memory
+	auto mapRing(int ringFileDescriptor, std::size_t size, off_t offset) -> std::span<std::byte>
+	{
+		auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFileDescriptor, offset);
+		if (address == MAP_FAILED)
+		{
+			throw std::system_error(errno, std::system_category(), "could not map io_uring");
+		}
+
+		return { static_cast<std::byte *>(address), size };
+	}
+
+	/// @brief Gets a pointer to a member of a mapped ring
+	template <typename Type>
+	auto ringMember(std::span<std::byte> ring, std::uint32_t offset) noexcept -> Type *
+	{
+		return reinterpret_cast<Type *>(ring.data() + offset);
+	}
+
+	/// @brief Calls io_uring_enter(), retrying if the call is interrupted by a signal
+	auto enter(int ringFileDescriptor, unsigned toSubmit, unsigned minCompletions, unsigned flags) noexcept -> int
+	{
+		for (;;)
+		{
+			const auto result = int(::syscall(__NR_io_uring_enter, ringFileDescriptor, toSubmit, minCompletions, flags, nullptr, 0));
+			if (result >= 0 || errno != EINTR)
+			{
+				return result;
+			}
+		}
+	}
+
+} // namespace
+
+IoRing::IoRing(unsigned entries)
+{
+	// Create the ring
+	io_uring_params parameters {};
+	_ringFileDescriptor = int(::syscall(__NR_io_uring_setup, entries, &parameters));
+	if (_ringFileDescriptor < 0)
+	{
+		throw std::system_error(errno, std::system_category(), "could not create io_uring");
+	}
+	_supportsTimeouts = (parameters.features & IORING_FEAT_EXT_ARG) != 0;
+
+	try
+	{
+		// Map the rings. Newer kernels use a single mapping for both rings.
+		const auto submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+		const auto completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+		if (parameters.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			_submissionRing = mapRing(_ringFileDescriptor, std::max(submissionRingSize, completionRingSize), IORING_OFF_SQ_RING);
+		}
+		else
+		{
+			_submissionRing = mapRing(_ringFileDescriptor, submissionRingSize, IORING_OFF_SQ_RING);
+			_completionRing = mapRing(_ringFileDescriptor, completionRingSize, IORING_OFF_CQ_RING);
+		}
+		const auto completionRing = _completionRing.empty() ? _submissionRing : _completionRing;
+
+		// Map the submission queue entries
+		const auto entriesMapping =
+			mapRing(_ringFileDescriptor, parameters.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+		_submissionEntries = { reinterpret_cast<io_uring_sqe *>(entriesMapping.data()), parameters.sq_entries };
+
+		// Get the ring members
+		_submissionHead = ringMember<unsigned>(_submissionRing, parameters.sq_off.head);
+		_submissionTail = ringMember<unsigned>(_submissionRing, parameters.sq_off.tail);
+		_submissionMask = *ringMember<unsigned>(_submissionRing, parameters.sq_off.ring_mask);
+		_submissionArray = ringMember<unsigned>(_submissionRing, parameters.sq_off.array);
+		_completionHead = ringMember<unsigned>(completionRing, parameters.cq_off.head);
+		_completionTail = ringMember<unsigned>(completionRing, parameters.cq_off.tail);
+		_completionMask = *ringMember<unsigned>(completionRing, parameters.cq_off.ring_mask);
+		_completionEntries = ringMember<io_uring_cqe>(completionRing, parameters.cq_off.cqes);
+	}
+	catch (...)
+	{
+		release();
+		throw;
+	}
+}
+
+IoRing::~IoRing() noexcept
+{
+	release();
+}
+
+auto IoRing::prepareRead(int fileDescriptor, std::span<std::byte> buffer, std::uint64_t userData) noexcept -> bool
+{
+	return prepareTransfer(IORING_OP_READ, fileDescriptor, buffer.data(), buffer.size(), userData);
+}
+
+auto IoRing::prepareWrite(int fileDescriptor, std::span<const std::byte> data, std::uint64_t userData) noexcept -> bool
+{
+	return prepareTransfer(IORING_OP_WRITE, fileDescriptor, data.data(), data.size(), userData);
+}
+
+auto IoRing::prepareCancel(std::uint64_t targetUserData, std::uint64_t userData) noexcept -> bool
+{
+	auto entry = nextEntry();
+	if (!entry)
+	{
+		return false;
+	}
+
+	entry->opcode = IORING_OP_ASYNC_CANCEL;
+	entry->fd = -1;
+	entry->addr = targetUserData;
+	entry->user_data = userData;
+	publishEntry();
+
+	return true;
+}
+
+auto IoRing::prepareCancelAll(std::uint64_t userData) noexcept -> bool
+{
+	auto entry = nextEntry();
+	if (!entry)
+	{
+		return false;
+	}
+
+	entry->opcode = IORING_OP_ASYNC_CANCEL;
+	entry->fd = -1;
+	entry->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+	entry->user_data = userData;
+	publishEntry();
+
+	return true;
+}
+
+auto IoRing::prepareTransfer(std::uint8_t opcode, int fileDescriptor, const void *address, std::size_t size, std::uint64_t userData) noexcept
+	-> bool
+{
+	auto entry = nextEntry();
+	if (!entry)
+	{
+		return false;
+	}
+
+	// An offset of -1 means that the current file position is used, which is the only offset that makes sense
+	// for pipes, sockets and character devices.
+	entry->opcode = opcode;
+	entry->fd = fileDescriptor;
+	entry->addr = std::uint64_t(reinterpret_cast<std::uintptr_t>(address));
+	entry->len = std::uint32_t(size);
+	entry->off = std::uint64_t(-1);
+	entry->user_data = userData;
+	publishEntry();
+
+	return true;
+}
+
+auto IoRing::nextEntry() noexcept -> io_uring_sqe *
+{
+	// The kernel advances the head, so we need to synchronize with it
+	const auto head = std::atomic_ref(*_submissionHead).load(std::memory_order_acquire);
+	const auto tail = *_submissionTail;
+
+	// Make sure the queue isn't full
+	if (tail - head >= _submissionEntries.size())
+	{
+		return nullptr;
+	}
+
+	const auto index = tail & _submissionMask;
+	auto &entry = _submissionEntries[index];
+	std::memset(&entry, 0, sizeof(entry));
+	_submissionArray[index] = index;
+
+	return &entry;
+}
+
+auto IoRing::publishEntry() noexcept -> void
+{
+	std::atomic_ref(*_submissionTail).store(*_submissionTail + 1, std::memory_order_release);
+	++_unsubmitted;
+}
+
+auto IoRing::submit() noexcept -> utils::eh::expected<void, std::error_code>
+{
+	while (_unsubmitted > 0)
+	{
+		const auto submitted = enter(_ringFileDescriptor, _unsubmitted, 0, 0);
+		if (submitted < 0)
+		{
+			return utils::eh::unexpected(std::error_code(errno, std::system_category()));
+		}
+		_unsubmitted -= unsigned(submitted);
+	}
+
+	return {};
+}
+
+auto IoRing::peekCompletion() noexcept -> std::optional<Completion>
+{
+	// The kernel advances the tail, so we need to synchronize with it
+	const auto head = *_completionHead;
+	const auto tail = std::atomic_ref(*_completionTail).load(std::memory_order_acquire);
+	if (head == tail)
+	{
+		return std::nullopt;
+	}
+
+	// Take the entry and hand the slot back to the kernel
+	const auto &entry = _completionEntries[head & _completionMask];
+	const Completion completion { ._userData = entry.user_data, ._result = entry.res };
+	std::atomic_ref(*_completionHead).store(head + 1, std::memory_order_release);
+
+	return completion;
+}
+
+auto IoRing::waitForCompletion() noexcept -> utils::eh::expected<Completion, std::error_code>
+{
+	for (;;)
+	{
+		if (auto completion = peekCompletion())
+		{
+			return *completion;
+		}
+
+		// Submit anything still pending and wait for at least one completion
+		const auto submitted = enter(_ringFileDescriptor, _unsubmitted, 1, IORING_ENTER_GETEVENTS);
+		if (submitted < 0)
+		{
+			return utils::eh::unexpected(std::error_code(errno, std::system_category()));
+		}
+		_unsubmitted -= unsigned(submitted);
+	}
+}
+
+auto IoRing::waitForCompletions(std::optional<std::chrono::nanoseconds> timeout) noexcept -> utils::eh::expected<void, std::error_code>
+{
+	// Wait for at least one completion, without submitting anything. Submitting is left to the threads holding the lock.
+	auto result = 0;
+	if (timeout && _supportsTimeouts)
+	{
+		const auto seconds = std::chrono::floor<std::chrono::seconds>(std::max(*timeout, std::chrono::nanoseconds::zero()));
+		__kernel_timespec timeSpec { .tv_sec = seconds.count(), .tv_nsec = (*timeout - seconds).count() };
+		io_uring_getevents_arg argument { .sigmask = 0, .sigmask_sz = 0, .pad = 0, .ts = std::uint64_t(reinterpret_cast<std::uintptr_t>(&timeSpec)) };
+		result = int(::syscall(__NR_io_uring_enter, _ringFileDescriptor, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &argument, sizeof(argument)));
+	}
+	else
+	{
+		result = int(::syscall(__NR_io_uring_enter, _ringFileDescriptor, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+	}
+
+	// Expired timeouts and signals are not errors. The caller will check for completions, and decide whether to wait again.
+	if (result < 0 && errno != ETIME && errno != EINTR)
+	{
+		return utils::eh::unexpected(std::error_code(errno, std::system_category()));
+	}
+
+	return {};
+}
+
+auto IoRing::withdrawUnsubmitted() noexcept -> void
+{
+	// The kernel only takes entries from the queue when we call io_uring_enter() with entries to submit, so entries that
+	// were not submitted can simply be removed by moving the tail back
+	std::atomic_ref(*_submissionTail).store(*_submissionTail - _unsubmitted, std::memory_order_release);
+	_unsubmitted = 0;
+}
+
+auto IoRing::release() noexcept -> void
+{
+	if (!_submissionEntries.empty())
+	{
+		::munmap(_submissionEntries.data(), _submissionEntries.size_bytes());
+	}
+	if (!_completionRing.empty())
+	{
+		::munmap(_completionRing.data(), _completionRing.size());
+	}
+	if (!_submissionRing.empty())
+	{
+		::munmap(_submissionRing.data(), _submissionRing.size());
+	}
+	if (_ringFileDescriptor >= 0)
+	{
+		::close(_ringFileDescriptor);
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
+
+#endif // defined(__linux__)
\ No newline at end of file
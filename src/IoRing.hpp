@@ -0,0 +1,157 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#if defined(__linux__)
+
+#include <xentara/utils/eh/expected.hpp>
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <system_error>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A minimal wrapper around a Linux io_uring instance
+///
+/// The ring allows many read and write operations to be in flight at the same time. Operations are queued using
+/// prepareRead() or prepareWrite(), handed to the kernel using submit(), and their results are collected using
+/// peekCompletion() or waitForCompletion(). Each operation carries a user data value that identifies it
+/// in the completion.
+///
+/// The ring uses the io_uring system calls directly, so it does not depend on liburing.
+/// @note This class is not thread safe. If the ring is used by more than one thread, the caller must serialize access.
+/// The only exception is waitForCompletions(), which one thread may call while other threads queue and submit operations.
+class IoRing final : private utils::tools::Unique
+{
+public:
+	/// @brief The result of a completed operation
+	struct Completion
+	{
+		/// @brief The user data the operation was prepared with
+		std::uint64_t _userData { 0 };
+		/// @brief The result of the operation. This is the number of bytes transferred, or a negated errno value.
+		std::int32_t _result { 0 };
+	};
+
+	/// @brief Constructor
+	/// @param entries The number of operations that can be queued at the same time
+	/// @throw std::system_error The ring could not be created
+	explicit IoRing(unsigned entries);
+
+	/// @brief Destructor
+	///
+	/// Any operations still in flight are cancelled by the kernel when the ring is destroyed.
+	~IoRing() noexcept;
+
+	/// @brief Queues a read operation
+	/// @param fileDescriptor The file descriptor to read from
+	/// @param buffer The buffer to read into. The buffer must remain valid until the operation has completed.
+	/// @param userData A value that identifies the operation in its completion
+	/// @return false if the submission queue is full
+	auto prepareRead(int fileDescriptor, std::span<std::byte> buffer, std::uint64_t userData) noexcept -> bool;
+
+	/// @brief Queues a write operation
+	/// @param fileDescriptor The file descriptor to write to
+	/// @param data The data to write. The data must remain valid until the operation has completed.
+	/// @param userData A value that identifies the operation in its completion
+	/// @return false if the submission queue is full
+	auto prepareWrite(int fileDescriptor, std::span<const std::byte> data, std::uint64_t userData) noexcept -> bool;
+
+	/// @brief Queues an operation that cancels another operation that is still in flight
+	/// @param targetUserData The user data of the operation to cancel
+	/// @param userData A value that identifies the cancel operation itself in its completion
+	/// @return false if the submission queue is full
+	auto prepareCancel(std::uint64_t targetUserData, std::uint64_t userData) noexcept -> bool;
+
+	/// @brief Queues an operation that cancels all other operations that are still in flight
+	/// @param userData A value that identifies the cancel operation itself in its completion
+	/// @return false if the submission queue is full
+	auto prepareCancelAll(std::uint64_t userData) noexcept -> bool;
+
+	/// @brief Hands all queued operations to the kernel
+	/// @return Nothing, or the error that occurred
+	auto submit() noexcept -> utils::eh::expected<void, std::error_code>;
+
+	/// @brief Gets the next completion, if there is one
+	auto peekCompletion() noexcept -> std::optional<Completion>;
+
+	/// @brief Waits for the next completion
+	/// @return The completion, or the error that occurred
+	auto waitForCompletion() noexcept -> utils::eh::expected<Completion, std::error_code>;
+
+	/// @brief Waits until there is at least one completion, without taking it
+	///
+	/// This function neither submits operations nor touches the completion queue, so it may be called without holding the lock
+	/// that serializes the other functions. Only one thread may call it at a time, however.
+	/// @param timeout The maximum time to wait, or std::nullopt to wait indefinitely. If the kernel does not support
+	/// timeouts, the function waits indefinitely.
+	/// @return Nothing, or the error that occurred. Returning because the timeout expired or because of a signal is not an error,
+	/// so the caller must use peekCompletion() to find out if a completion has actually arrived.
+	auto waitForCompletions(std::optional<std::chrono::nanoseconds> timeout) noexcept -> utils::eh::expected<void, std::error_code>;
+
+	/// @brief Removes all queued operations that have not been submitted yet
+	///
+	/// This is used if submit() fails, so that the operations are not submitted later, after the buffers they refer to
+	/// have been released.
+	auto withdrawUnsubmitted() noexcept -> void;
+
+private:
+	/// @brief Gets the next free submission queue entry
+	/// @return The entry, which has been zeroed, or nullptr if the queue is full
+	auto nextEntry() noexcept -> io_uring_sqe *;
+	/// @brief Publishes the entry returned by nextEntry() to the kernel
+	auto publishEntry() noexcept -> void;
+
+	/// @brief Queues a read or write operation
+	auto prepareTransfer(std::uint8_t opcode, int fileDescriptor, const void *address, std::size_t size, std::uint64_t userData) noexcept
+		-> bool;
+
+	/// @brief Unmaps the rings and closes the file descriptor
+	auto release() noexcept -> void;
+
+	/// @brief The file descriptor of the ring
+	int _ringFileDescriptor { -1 };
+
+	/// @brief The mapped submission ring
+	std::span<std::byte> _submissionRing;
+	/// @brief The mapped completion ring. This is empty if it shares the mapping with the submission ring.
+	std::span<std::byte> _completionRing;
+	/// @brief The mapped submission queue entries
+	std::span<io_uring_sqe> _submissionEntries;
+
+	/// @brief The head of the submission ring, which is advanced by the kernel
+	unsigned *_submissionHead { nullptr };
+	/// @brief The tail of the submission ring, which is advanced by us
+	unsigned *_submissionTail { nullptr };
+	/// @brief The mask used to wrap indices into the submission ring
+	unsigned _submissionMask { 0 };
+	/// @brief The array of submission queue entry indices
+	unsigned *_submissionArray { nullptr };
+
+	/// @brief The head of the completion ring, which is advanced by us
+	unsigned *_completionHead { nullptr };
+	/// @brief The tail of the completion ring, which is advanced by the kernel
+	unsigned *_completionTail { nullptr };
+	/// @brief The mask used to wrap indices into the completion ring
+	unsigned _completionMask { 0 };
+	/// @brief The completion queue entries
+	io_uring_cqe *_completionEntries { nullptr };
+
+	/// @brief The number of operations that have been queued but not submitted yet
+	unsigned _unsubmitted { 0 };
+
+	/// @brief Whether the kernel supports waiting with a timeout
+	bool _supportsTimeouts { false };
+};
+
+} // namespace xentara::plugins::templateDriver
+
+#endif // defined(__linux__)
\ No newline at end of file
@@ -2,9 +2,12 @@
 #include "PerValueReadState.hpp"
 
 #include "Attributes.hpp"
+#include "ChangeDetection.hpp"
 
 #include <xentara/memory/WriteSentinel.hpp>
 
+#include <bit>
+
 namespace xentara::plugins::templateDriver
 {
 
@@ -31,7 +34,7 @@ auto PerValueReadState<DataType>::makeReadHandle(const DataBlock &dataBlock,
 	// Try each readable attribute
 	if (attribute == model::Attribute::kChangeTime)
 	{
-		return dataBlock.member(_stateHandle, &State::_changeTime);
+		return dataBlock.member(_changeTimeHandle, &ChangeTime::_changeTime);
 	}
 
 	return std::nullopt;
@@ -40,51 +43,141 @@ auto PerValueReadState<DataType>::makeReadHandle(const DataBlock &dataBlock,
 template <std::regular DataType>
 auto PerValueReadState<DataType>::valueReadHandle(const DataBlock &dataBlock) const noexcept -> data::ReadHandle
 {
-	return dataBlock.member(_stateHandle, &State::_value);
+	return dataBlock.member(_valueHandle, &Value::_value);
 }
 
 template <std::regular DataType>
-auto PerValueReadState<DataType>::attach(memory::Array &dataArray, std::size_t &eventCount) -> void
+auto PerValueReadState<DataType>::attach(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void
 {
-	// Add the state to the array
-	_stateHandle = dataArray.appendObject<State>();
+	// Add the value to the array
+	if (attachesValues(pass))
+	{
+		_valueHandle = dataArray.appendObject<Value>();
+	}
+
+	// Add the change time to the array
+	if (attachesMetadata(pass))
+	{
+		_changeTimeHandle = dataArray.appendObject<ChangeTime>();
 
-	// Add the number of events that can be raised at once, which is just the one event we have.
-	eventCount += 1;
+		// Add the number of events that can be raised at once, which is just the one event we have.
+		eventCount += 1;
+	}
+}
+
+template <std::regular DataType>
+auto PerValueReadState<DataType>::descriptor(std::size_t payloadOffset) noexcept -> Descriptor
+{
+	return { ._payloadOffset = payloadOffset,
+		._valueHandle = _valueHandle,
+		._changeTimeHandle = _changeTimeHandle,
+		._changedEvent = &_changedEvent };
 }
 
 template <std::regular DataType>
 auto PerValueReadState<DataType>::update(
 	WriteSentinel &writeSentinel,
+	std::span<const Descriptor> descriptors,
 	std::chrono::system_clock::time_point timeStamp,
-	const utils::eh::expected<DataType, std::error_code> &valueOrError,
+	std::span<const DataType> values,
+	std::span<const std::uint64_t> changeMask,
 	const CommonReadState::Changes &commonChanges,
+	bool raiseEvents,
 	PendingEventList &eventsToRaise) -> void
 {
-	// Get the correct array entry
-	auto &state = writeSentinel[_stateHandle];
-	const auto &oldState = writeSentinel.oldValues()[_stateHandle];
+	// If the common state changed, all the values count as changed
+	const auto allChanged = bool(commonChanges);
 
-	// Set the value, replacing errors with a default constructed value
-	state._value = valueOrError.value_or(DataType());
+	// Write all the states
+	for (std::size_t index = 0; index < descriptors.size(); ++index)
+	{
+		// Get the correct array entries
+		const auto &descriptor = descriptors[index];
+		auto &changeTime = writeSentinel[descriptor._changeTimeHandle];
+		const auto &oldChangeTime = writeSentinel.oldValues()[descriptor._changeTimeHandle];
+
+		// Set the value
+		writeSentinel[descriptor._valueHandle]._value = values[index];
+
+		// Update the change time, if necessary. We always need to write the change time, even if it is the same as before,
+		// because memory resources use swap-in.
+		const auto changed = allChanged || isChanged(changeMask, index);
+		changeTime._changeTime = changed ? timeStamp : oldChangeTime._changeTime;
+	}
 
-	// Detect changes
-	const auto valueChanged = state._value != oldState._value;
-	const auto changed = valueChanged || commonChanges;
+	// Cause the correct events to be raised
+	if (!raiseEvents)
+	{
+		return;
+	}
+	if (allChanged)
+	{
+		for (auto &&descriptor : descriptors)
+		{
+			eventsToRaise.push_back(*descriptor._changedEvent);
+		}
+	}
+	// Only visit the values whose bits are set
+	else
+	{
+		for (std::size_t word = 0; word < changeMask.size(); ++word)
+		{
+			for (auto bits = changeMask[word]; bits != 0; bits &= bits - 1)
+			{
+				const auto index = word * kChangeMaskBits + std::size_t(std::countr_zero(bits));
+				eventsToRaise.push_back(*descriptors[index]._changedEvent);
+			}
+		}
+	}
+}
+
+template <std::regular DataType>
+auto PerValueReadState<DataType>::keep(WriteSentinel &writeSentinel, std::span<const Descriptor> descriptors) -> void
+{
+	// Copy the states without looking at them
+	for (auto &&descriptor : descriptors)
+	{
+		writeSentinel[descriptor._valueHandle] = writeSentinel.oldValues()[descriptor._valueHandle];
+		writeSentinel[descriptor._changeTimeHandle] = writeSentinel.oldValues()[descriptor._changeTimeHandle];
+	}
+}
 
-	// Update the change time, if necessary. We always need to write the change time, even if it is the same as before,
-	// because memory resources use swap-in.
-	state._changeTime = changed ? timeStamp : oldState._changeTime;
+template <std::regular DataType>
+auto PerValueReadState<DataType>::invalidate(WriteSentinel &writeSentinel,
+	std::span<const Descriptor> descriptors,
+	std::chrono::system_clock::time_point timeStamp,
+	bool raiseEvents,
+	PendingEventList &eventsToRaise) -> void
+{
+	// Reset all the states in one sweep
+	for (auto &&descriptor : descriptors)
+	{
+		writeSentinel[descriptor._valueHandle]._value = DataType();
+		writeSentinel[descriptor._changeTimeHandle]._changeTime = timeStamp;
+	}
 
-	// Cause the correct events to be raised
-	if (changed)
+	// All the values changed
+	if (raiseEvents)
 	{
-		eventsToRaise.push_back(_changedEvent);
+		for (auto &&descriptor : descriptors)
+		{
+			eventsToRaise.push_back(*descriptor._changedEvent);
+		}
 	}
 }
 
 /// @class xentara::plugins::templateDriver::PerValueReadState
-/// @todo add template instantiations for other supported types
+/// @todo add template instantiations for any additional value types
+template class PerValueReadState<bool>;
+template class PerValueReadState<std::int8_t>;
+template class PerValueReadState<std::uint8_t>;
+template class PerValueReadState<std::int16_t>;
+template class PerValueReadState<std::uint16_t>;
+template class PerValueReadState<std::int32_t>;
+template class PerValueReadState<std::uint32_t>;
+template class PerValueReadState<std::int64_t>;
+template class PerValueReadState<std::uint64_t>;
+template class PerValueReadState<float>;
 template class PerValueReadState<double>;
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Types.hpp"
 #include "Attributes.hpp"
 #include "CommonReadState.hpp"
+#include "DataLayout.hpp"
 
 #include <xentara/data/ReadHandle.hpp>
 #include <xentara/memory/Array.hpp>
@@ -11,12 +12,14 @@
 #include <xentara/model/ForEachAttributeFunction.hpp>
 #include <xentara/model/ForEachEventFunction.hpp>
 #include <xentara/process/Event.hpp>
-#include <xentara/utils/eh/expected.hpp>
 
 #include <chrono>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <memory>
+#include <span>
 
 namespace xentara::plugins::templateDriver
 {
@@ -27,7 +30,44 @@ namespace xentara::plugins::templateDriver
 template <std::regular DataType>
 class PerValueReadState final
 {
+private:
+	/// @brief This structure is used to represent the value inside the memory block
+	///
+	/// The value and the change time are kept in separate array elements, so that they can be placed in separate columns
+	/// if the I/O transaction uses DataLayout::Columns.
+	struct Value final
+	{
+		/// @brief The current value
+		DataType _value {};
+	};
+
+	/// @brief This structure is used to represent the change time inside the memory block
+	struct ChangeTime final
+	{
+		/// @brief The change time stamp
+		std::chrono::system_clock::time_point _changeTime { std::chrono::system_clock::time_point::min() };
+	};
+
 public:
+	/// @brief Everything needed to decode and update a single value.
+	///
+	/// Descriptors are collected into a flat table when the I/O transaction is prepared, so that the values can be updated
+	/// in a tight loop, without having to make virtual calls to the individual data points.
+	struct Descriptor
+	{
+		/// @brief The type of the value
+		using ValueType = DataType;
+
+		/// @brief The offset of the value within the payload of the read command. This is used to find values that can be decoded together.
+		std::size_t _payloadOffset { 0 };
+		/// @brief The array element that contains the value
+		memory::Array::ObjectHandle<Value> _valueHandle;
+		/// @brief The array element that contains the change time
+		memory::Array::ObjectHandle<ChangeTime> _changeTimeHandle;
+		/// @brief The event to raise if the value changes
+		process::Event *_changedEvent { nullptr };
+	};
+
 	/// @brief Iterates over all the attributes that belong to this state.
 	/// @param function The function that should be called for each attribute
 	/// @return The return value of the last function call
@@ -64,42 +104,78 @@ public:
 	/// @param eventCount A variable that counts the total number of events than can be raised for a single update.
 	/// The maximum number of events that update() will request to be raised will be added to this variable. The caller will use this
 	/// event count to preallocate a buffer when collecting the events to raise after an update.
-	auto attach(memory::Array &dataArray, std::size_t &eventCount) -> void;
+	/// @param pass The parts of the state to add to the array
+	auto attach(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void;
 
-	/// @brief Updates the data and collects the events to send
+	/// @brief Creates a descriptor for the state
+	/// @param payloadOffset The offset of the value within the payload of the read command
+	auto descriptor(std::size_t payloadOffset) noexcept -> Descriptor;
+
+	/// @brief Updates the data of a number of states and collects the events to send
 	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param descriptors The descriptors of the states to update
 	/// @param timeStamp The update time stamp
-	/// @param valueOrError This is a variant-like type that will hold either the new value, or an std::error_code object
-	/// containing a read error.
+	/// @param values The new values, one for each descriptor
+	/// @param changeMask A bit mask that has a bit set for each value that differs from the currently committed value.
+	/// The mask must have been created using detectChanges().
 	/// @param commonChanges An object containing information about which parts of the common read state changed, if any.
+	/// @param raiseEvents Whether to raise the changed events of the values that changed
 	/// @param eventsToRaise Any events that need to be raised as a result of the update will be added to this
 	/// list. The events will not be raised directly, because the write sentinel needs to be commited first,
 	/// which is done by the caller.
-	auto update(WriteSentinel &writeSentinel,
+	static auto update(WriteSentinel &writeSentinel,
+		std::span<const Descriptor> descriptors,
 		std::chrono::system_clock::time_point timeStamp,
-		const utils::eh::expected<DataType, std::error_code> &valueOrError,
+		std::span<const DataType> values,
+		std::span<const std::uint64_t> changeMask,
 		const CommonReadState::Changes &commonChanges,
+		bool raiseEvents,
 		PendingEventList &eventsToRaise) -> void;
 
-private:
-	/// @brief This structure is used to represent the state inside the memory block
-	struct State final
-	{
-		/// @brief The current value
-		DataType _value {};
-		/// @brief The change time stamp
-		std::chrono::system_clock::time_point _changeTime { std::chrono::system_clock::time_point::min() };
-	};
+	/// @brief Keeps the currently committed data of a number of states
+	///
+	/// This is used if it is known that none of the values have changed. The states must still be written, because memory
+	/// resources use swap-in.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param descriptors The descriptors of the states to keep
+	static auto keep(WriteSentinel &writeSentinel, std::span<const Descriptor> descriptors) -> void;
 
+	/// @brief Resets a number of states because the data is no longer being acquired, and collects the events to send
+	///
+	/// All the values are reset to a default constructed value and count as changed, so no comparison is performed.
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param descriptors The descriptors of the states to reset
+	/// @param timeStamp The update time stamp
+	/// @param raiseEvents Whether to raise the changed events of the values
+	/// @param eventsToRaise The changed events will be added to this list, if *raiseEvents* is true.
+	static auto invalidate(WriteSentinel &writeSentinel,
+		std::span<const Descriptor> descriptors,
+		std::chrono::system_clock::time_point timeStamp,
+		bool raiseEvents,
+		PendingEventList &eventsToRaise) -> void;
+
+private:
 	/// @brief A summary event that is raised when anything changes
 	process::Event _changedEvent { io::Direction::Input };
 
-	/// @brief The array element that contains the state
-	memory::Array::ObjectHandle<State> _stateHandle;
+	/// @brief The array element that contains the value
+	memory::Array::ObjectHandle<Value> _valueHandle;
+	/// @brief The array element that contains the change time
+	memory::Array::ObjectHandle<ChangeTime> _changeTimeHandle;
 };
 
 /// @class xentara::plugins::templateDriver::PerValueReadState
-/// @todo add extern template statements for other supported types
+/// @todo add extern template statements for any additional value types
+extern template class PerValueReadState<bool>;
+extern template class PerValueReadState<std::int8_t>;
+extern template class PerValueReadState<std::uint8_t>;
+extern template class PerValueReadState<std::int16_t>;
+extern template class PerValueReadState<std::uint16_t>;
+extern template class PerValueReadState<std::int32_t>;
+extern template class PerValueReadState<std::uint32_t>;
+extern template class PerValueReadState<std::int64_t>;
+extern template class PerValueReadState<std::uint64_t>;
+extern template class PerValueReadState<float>;
 extern template class PerValueReadState<double>;
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
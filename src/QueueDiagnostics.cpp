@@ -0,0 +1,40 @@
+// Copyright (c) embedded ocean GmbH
+#include "QueueDiagnostics.hpp"
+
+#include "Attributes.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto QueueDiagnostics::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support
+	return function(attributes::kQueueOverflowCount);
+}
+
+auto QueueDiagnostics::makeReadHandle(const DataBlock &dataBlock,
+	const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	// Try each readable attribute
+	if (attribute == attributes::kQueueOverflowCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_overflowCount);
+	}
+
+	return std::nullopt;
+}
+
+auto QueueDiagnostics::attach(memory::Array &dataArray) -> void
+{
+	// Add the state to the array
+	_stateHandle = dataArray.appendObject<State>();
+}
+
+auto QueueDiagnostics::update(WriteSentinel &writeSentinel, std::uint64_t overflowCount) -> void
+{
+	writeSentinel[_stateHandle]._overflowCount = overflowCount;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
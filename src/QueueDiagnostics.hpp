@@ -0,0 +1,56 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "Attributes.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+
+#include <cstdint>
+#include <optional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Diagnostic information about the queue that holds the pending values of an output.
+class QueueDiagnostics final
+{
+public:
+	/// @brief Iterates over all the attributes that belong to the diagnostics.
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Creates a read-handle for an attribute that belong to the diagnostics.
+	/// @param dataBlock The data block the data is stored in
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown
+	auto makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
+		-> std::optional<data::ReadHandle>;
+
+	/// @brief Attaches the diagnostics to its I/O transaction
+	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
+	/// to allocate the data block.
+	auto attach(memory::Array &dataArray) -> void;
+
+	/// @brief Updates the data
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	/// @param overflowCount The number of values that were discarded because the queue was full
+	auto update(WriteSentinel &writeSentinel, std::uint64_t overflowCount) -> void;
+
+private:
+	/// @brief This structure is used to represent the diagnostics inside the memory block
+	struct State final
+	{
+		/// @brief The number of values that were discarded because the queue was full
+		std::uint64_t _overflowCount { 0 };
+	};
+
+	/// @brief The array element that contains the state
+	memory::Array::ObjectHandle<State> _stateHandle;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Copyright (c) embedded ocean GmbH
+#include "ReadCoalescer.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto ReadCoalescer::addParticipant(std::span<const ReadPlanner::Range> ranges) -> std::size_t
+{
+	// A range cannot be split across several combined commands, so it must fit into a single one
+	if (std::ranges::any_of(ranges, [this](const auto &range) { return range._size > _maxCommandSize; }))
+	{
+		/// @todo replace "template I/O transaction" and "template I/O component" with more descriptive names
+		throw std::runtime_error("a read command of a template I/O transaction is larger than the maximum coalesced read size of its template I/O component");
+	}
+
+	// Add the slices
+	const auto participant = _participants.size();
+	_participants.push_back({ ._firstSlice = _slices.size(), ._sliceCount = ranges.size() });
+	for (auto &&range : ranges)
+	{
+		_slices.push_back({ ._address = range._address, ._size = range._size });
+	}
+
+	// Recompile the combined commands
+	compile();
+
+	return participant;
+}
+
+auto ReadCoalescer::clear() noexcept -> void
+{
+	_participants.clear();
+	_slices.clear();
+	_commands.clear();
+	for (auto &&buffer : _receiveBuffers)
+	{
+		buffer.clear();
+	}
+	_lastRead.reset();
+	_lastError.clear();
+}
+
+auto ReadCoalescer::compile() -> void
+{
+	// Visit the slices by address. The slices of different participants may overlap.
+	std::vector<std::size_t> order(_slices.size());
+	std::iota(order.begin(), order.end(), std::size_t(0));
+	std::ranges::stable_sort(order, {}, [this](std::size_t index) { return _slices[index]._address; });
+
+	// Merge the slices into ranges using the gap rule
+	struct CommandRange
+	{
+		std::uint64_t _address;
+		std::size_t _size;
+		std::size_t _bufferOffset;
+	};
+	std::vector<CommandRange> commandRanges;
+	for (auto &&index : order)
+	{
+		auto &slice = _slices[index];
+		const auto end = slice._address + slice._size;
+
+		// Try to append the slice to the current range
+		if (!commandRanges.empty())
+		{
+			auto &current = commandRanges.back();
+			const auto currentEnd = current._address + current._size;
+			const auto gap = slice._address > currentEnd ? std::size_t(slice._address - currentEnd) : std::size_t(0);
+			const auto newSize = std::size_t(std::max(end, currentEnd) - current._address);
+
+			if (gap <= _maxGap && newSize <= _maxCommandSize)
+			{
+				current._size = newSize;
+				slice._command = commandRanges.size() - 1;
+				slice._offset = std::size_t(slice._address - current._address);
+				continue;
+			}
+		}
+
+		// Start a new range
+		commandRanges.push_back({ ._address = slice._address, ._size = slice._size, ._bufferOffset = 0 });
+		slice._command = commandRanges.size() - 1;
+		slice._offset = 0;
+	}
+
+	// Lay out the ranges in the receive buffers
+	std::size_t receiveSize = 0;
+	for (auto &&range : commandRanges)
+	{
+		range._bufferOffset = receiveSize;
+		receiveSize += range._size;
+	}
+	for (auto &&buffer : _receiveBuffers)
+	{
+		buffer.assign(receiveSize, std::byte(0));
+	}
+
+	// Create the commands
+	/// @todo register the receive buffers with the I/O component, like the buffers of the individual transactions
+	_commands.clear();
+	_commands.reserve(commandRanges.size());
+	for (auto &&range : commandRanges)
+	{
+		auto &command = _commands.emplace_back(std::make_unique<ReadCommand>(range._address, range._size));
+		command->assignReceiveBuffers(std::span(_receiveBuffers[0]).subspan(range._bufferOffset, range._size),
+			std::span(_receiveBuffers[1]).subspan(range._bufferOffset, range._size));
+	}
+
+	// The commands have to be read again
+	_lastRead.reset();
+	_lastError.clear();
+}
+
+auto ReadCoalescer::receive(std::size_t participant, std::span<ReadCommand *const> commands) const noexcept -> void
+{
+	const auto &[firstSlice, sliceCount] = _participants[participant];
+	for (std::size_t index = 0; index < sliceCount; ++index)
+	{
+		const auto &slice = _slices[firstSlice + index];
+		const auto &combined = _commands[slice._command]->payload();
+		auto &command = *commands[index];
+		std::ranges::copy(combined.data().subspan(slice._offset, slice._size), command.receiveBuffer().begin());
+		command.completeReceive();
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,150 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "ReadCommand.hpp"
+#include "ReadPlanner.hpp"
+
+#include <xentara/utils/tools/Unique.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Merges the reads of several I/O transactions of the same I/O component into combined read commands
+///
+/// Each participating I/O transaction contributes the address ranges it reads. The ranges of all participants are
+/// merged into as few combined commands as possible, using the same gap rule as the ReadPlanner. The first participant
+/// that reads within a coalescing window sends the combined commands; all participants that read within the same window
+/// are served from the reply, without another round trip.
+///
+/// The data of each participant is copied out of the combined commands into the participant's own read commands, while
+/// the I/O component holds its lock. A participant therefore never decodes data that is being received for another participant.
+/// @note This class is not thread safe. The I/O component serializes access to it.
+class ReadCoalescer final : private utils::tools::Unique
+{
+public:
+	/// @brief Sets the coalescing window
+	auto setWindow(std::chrono::nanoseconds window) noexcept -> void
+	{
+		_window = window;
+	}
+
+	/// @brief Gets the coalescing window
+	auto window() const noexcept -> std::chrono::nanoseconds
+	{
+		return _window;
+	}
+
+	/// @brief Sets the maximum number of unused bytes that may be read across to avoid an additional command
+	auto setMaxGap(std::size_t maxGap) noexcept -> void
+	{
+		_maxGap = maxGap;
+	}
+
+	/// @brief Sets the maximum number of bytes a single combined command may read
+	auto setMaxCommandSize(std::size_t maxCommandSize) noexcept -> void
+	{
+		_maxCommandSize = maxCommandSize;
+	}
+
+	/// @brief Adds a participant, and recompiles the combined commands
+	/// @param ranges The address ranges the participant reads
+	/// @return An index that identifies the participant
+	/// @throw std::runtime_error A range is larger than the maximum combined command size
+	auto addParticipant(std::span<const ReadPlanner::Range> ranges) -> std::size_t;
+
+	/// @brief Removes all participants and commands
+	auto clear() noexcept -> void;
+
+	/// @brief Gets the combined commands
+	auto commands() const noexcept -> std::span<const std::unique_ptr<ReadCommand>>
+	{
+		return _commands;
+	}
+
+	/// @brief Checks whether the combined commands have been read within the coalescing window
+	/// @param timeStamp The time stamp of the read that is about to be performed
+	auto isCurrent(std::chrono::system_clock::time_point timeStamp) const noexcept -> bool
+	{
+		return _lastRead && timeStamp >= *_lastRead && timeStamp - *_lastRead < _window;
+	}
+
+	/// @brief Records the result of reading the combined commands
+	/// @param timeStamp The time stamp of the read
+	/// @param error The read error, or a default constructed std::error_code object if all combined commands were read successfully.
+	auto setResult(std::chrono::system_clock::time_point timeStamp, std::error_code error) noexcept -> void
+	{
+		_lastRead = timeStamp;
+		_lastError = error;
+	}
+
+	/// @brief Gets the error that occurred during the last read of the combined commands
+	auto lastError() const noexcept -> std::error_code
+	{
+		return _lastError;
+	}
+
+	/// @brief Copies the data of a participant's ranges from the payloads of the combined commands into the participant's commands
+	/// @param participant The index of the participant, as returned by addParticipant()
+	/// @param commands The participant's read commands, one for each range the participant added. The data is copied into the
+	/// receive buffer of each command, and becomes the command's new payload.
+	auto receive(std::size_t participant, std::span<ReadCommand *const> commands) const noexcept -> void;
+
+private:
+	/// @brief The part of a combined command that corresponds to a participant's range
+	struct Slice
+	{
+		/// @brief The address of the range
+		std::uint64_t _address { 0 };
+		/// @brief The size of the range
+		std::size_t _size { 0 };
+		/// @brief The index of the combined command that reads the range
+		std::size_t _command { 0 };
+		/// @brief The offset of the range within the payload of the combined command
+		std::size_t _offset { 0 };
+	};
+
+	/// @brief The slices of a participant
+	struct Participant
+	{
+		/// @brief The index of the first slice
+		std::size_t _firstSlice { 0 };
+		/// @brief The number of slices
+		std::size_t _sliceCount { 0 };
+	};
+
+	/// @brief Merges the slices of all participants into combined commands
+	auto compile() -> void;
+
+	/// @brief The coalescing window
+	std::chrono::nanoseconds _window { 0 };
+	/// @brief The maximum number of unused bytes that may be read across
+	std::size_t _maxGap { ReadPlanner::kDefaultMaxGap };
+	/// @brief The maximum number of bytes a single combined command may read
+	std::size_t _maxCommandSize { ReadPlanner::kDefaultMaxCommandSize };
+
+	/// @brief The participants
+	std::vector<Participant> _participants;
+	/// @brief The slices of all participants
+	std::vector<Slice> _slices;
+	/// @brief The combined commands
+	std::vector<std::unique_ptr<ReadCommand>> _commands;
+	/// @brief The two buffers the combined commands are received into
+	std::array<std::vector<std::byte>, 2> _receiveBuffers;
+
+	/// @brief The time stamp of the last read of the combined commands
+	std::optional<std::chrono::system_clock::time_point> _lastRead;
+	/// @brief The error that occurred during the last read of the combined commands
+	std::error_code _lastError;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -3,19 +3,132 @@
 
 #include <xentara/utils/tools/Unique.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
 namespace xentara::plugins::templateDriver
 {
 
 /// @brief A command used to read inputs
+///
+/// Each command reads a single contiguous address range from the I/O component. The data is received directly into
+/// one of two receive buffers that are allocated and registered by the I/O component when the I/O transaction is prepared.
+/// The two buffers are used alternately, so that the payload of the previous read remains valid while receiving the next.
 /// @todo implement a proper read command
 class ReadCommand final : private utils::tools::Unique
 {
 public:
-	/// @brief Some class that represents the data received from the device
-	/// @todo use a suitable class to represent the data
+	/// @brief A non-owning view of the data received from the device
+	/// @todo add any additional information the I/O component returns
 	class Payload final
 	{
+	public:
+		/// @brief Default constructor for an empty payload
+		constexpr Payload() noexcept = default;
+
+		/// @brief Constructor
+		/// @param address The address of the first byte of the payload
+		/// @param data The data. The data is not copied, so the buffer must outlive the payload.
+		constexpr Payload(std::uint64_t address, std::span<const std::byte> data) noexcept : _address(address), _data(data)
+		{
+		}
+
+		/// @brief Gets the address of the first byte of the payload
+		constexpr auto address() const noexcept -> std::uint64_t
+		{
+			return _address;
+		}
+
+		/// @brief Gets the data received from the device
+		constexpr auto data() const noexcept -> std::span<const std::byte>
+		{
+			return _data;
+		}
+
+	private:
+		/// @brief The address of the first byte
+		std::uint64_t _address { 0 };
+		/// @brief The data
+		std::span<const std::byte> _data;
 	};
+
+	/// @brief Constructor
+	/// @param address The address of the first byte to read
+	/// @param size The number of bytes to read
+	constexpr ReadCommand(std::uint64_t address, std::size_t size) noexcept : _address(address), _size(size)
+	{
+	}
+
+	/// @brief Gets the address of the first byte to read
+	constexpr auto address() const noexcept -> std::uint64_t
+	{
+		return _address;
+	}
+
+	/// @brief Gets the number of bytes to read
+	constexpr auto size() const noexcept -> std::size_t
+	{
+		return _size;
+	}
+
+	/// @brief Assigns the receive buffers
+	/// @param first The first buffer. This must be at least size() bytes long.
+	/// @param second The second buffer. This must be at least size() bytes long.
+	constexpr auto assignReceiveBuffers(std::span<std::byte> first, std::span<std::byte> second) noexcept -> void
+	{
+		_receiveBuffers = { first.first(_size), second.first(_size) };
+		_receiveBufferIndex = 0;
+		_payload = { _address, _receiveBuffers[1] };
+		_previousPayload = _payload;
+	}
+
+	/// @brief Gets the buffer the data for the next read should be received into
+	///
+	/// This is always the buffer that does not contain the current payload.
+	constexpr auto receiveBuffer() const noexcept -> std::span<std::byte>
+	{
+		return _receiveBuffers[_receiveBufferIndex];
+	}
+
+	/// @brief Marks the data in the receive buffer as valid, and makes it the current payload
+	/// @return The new payload
+	constexpr auto completeReceive() noexcept -> const Payload &
+	{
+		_previousPayload = _payload;
+		_payload = { _address, _receiveBuffers[_receiveBufferIndex] };
+		_receiveBufferIndex ^= 1;
+		return _payload;
+	}
+
+	/// @brief Gets the payload received for the last read
+	constexpr auto payload() const noexcept -> const Payload &
+	{
+		return _payload;
+	}
+
+	/// @brief Gets the payload received for the read before the last
+	constexpr auto previousPayload() const noexcept -> const Payload &
+	{
+		return _previousPayload;
+	}
+
+private:
+	/// @brief The address of the first byte to read
+	std::uint64_t _address { 0 };
+	/// @brief The number of bytes to read
+	std::size_t _size { 0 };
+
+	/// @brief The two receive buffers
+	std::array<std::span<std::byte>, 2> _receiveBuffers;
+	/// @brief The index of the buffer the next read will be received into
+	std::size_t _receiveBufferIndex { 0 };
+
+	/// @brief The current payload
+	Payload _payload;
+	/// @brief The previous payload
+	Payload _previousPayload;
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,69 @@
+// Copyright (c) embedded ocean GmbH
+#include "ReadDiagnostics.hpp"
+
+#include "Attributes.hpp"
+
+#include <xentara/memory/WriteSentinel.hpp>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto ReadDiagnostics::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// Handle all the attributes we support
+	return
+		function(attributes::kReadCommandCount) ||
+		function(attributes::kReadByteCount) ||
+		function(attributes::kReadGapByteCount) ||
+		function(attributes::kReadCount) ||
+		function(attributes::kUnchangedReadCount);
+}
+
+auto ReadDiagnostics::makeReadHandle(const DataBlock &dataBlock,
+	const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	// Try each readable attribute
+	if (attribute == attributes::kReadCommandCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_readCommandCount);
+	}
+	else if (attribute == attributes::kReadByteCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_readByteCount);
+	}
+	else if (attribute == attributes::kReadGapByteCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_readGapByteCount);
+	}
+	else if (attribute == attributes::kReadCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_readCount);
+	}
+	else if (attribute == attributes::kUnchangedReadCount)
+	{
+		return dataBlock.member(_stateHandle, &State::_unchangedReadCount);
+	}
+
+	return std::nullopt;
+}
+
+auto ReadDiagnostics::attach(memory::Array &dataArray) -> void
+{
+	// Add the state to the array
+	_stateHandle = dataArray.appendObject<State>();
+}
+
+auto ReadDiagnostics::setReadPlan(std::size_t commandCount, std::size_t byteCount, std::size_t gapByteCount) noexcept -> void
+{
+	_values._readCommandCount = std::uint32_t(commandCount);
+	_values._readByteCount = byteCount;
+	_values._readGapByteCount = gapByteCount;
+}
+
+auto ReadDiagnostics::update(WriteSentinel &writeSentinel) -> void
+{
+	// We always need to write all the values, even if they are the same as before, because memory resources use swap-in.
+	writeSentinel[_stateHandle] = _values;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,81 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "Types.hpp"
+#include "Attributes.hpp"
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Diagnostic information about the read operations of an I/O transaction.
+class ReadDiagnostics final
+{
+public:
+	/// @brief Iterates over all the attributes that belong to the diagnostics.
+	/// @param function The function that should be called for each attribute
+	/// @return The return value of the last function call
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool;
+
+	/// @brief Creates a read-handle for an attribute that belong to the diagnostics.
+	/// @param dataBlock The data block the data is stored in
+	/// @param attribute The attribute to create the handle for
+	/// @return A read handle for the attribute, or std::nullopt if the attribute is unknown
+	auto makeReadHandle(const DataBlock &dataBlock, const model::Attribute &attribute) const noexcept
+		-> std::optional<data::ReadHandle>;
+
+	/// @brief Attaches the diagnostics to its I/O transaction
+	/// @param dataArray The data array that the attributes should be added to. The caller will use the information in this array
+	/// to allocate the data block.
+	auto attach(memory::Array &dataArray) -> void;
+
+	/// @brief Sets the information about the read plan
+	/// @param commandCount The number of read commands
+	/// @param byteCount The total number of bytes read by all commands
+	/// @param gapByteCount The number of bytes read that are not needed by any input
+	auto setReadPlan(std::size_t commandCount, std::size_t byteCount, std::size_t gapByteCount) noexcept -> void;
+
+	/// @brief Counts a read
+	/// @param unchanged Whether the payload of the read was identical to the previous one
+	auto countRead(bool unchanged) noexcept -> void
+	{
+		++_values._readCount;
+		_values._unchangedReadCount += unchanged ? 1 : 0;
+	}
+
+	/// @brief Updates the data
+	/// @param writeSentinel A write sentinel for the data block the data is stored in
+	auto update(WriteSentinel &writeSentinel) -> void;
+
+private:
+	/// @brief This structure is used to represent the diagnostics inside the memory block
+	struct State final
+	{
+		/// @brief The number of read commands
+		std::uint32_t _readCommandCount { 0 };
+		/// @brief The total number of bytes read by all commands
+		std::uint64_t _readByteCount { 0 };
+		/// @brief The number of bytes read that are not needed by any input
+		std::uint64_t _readGapByteCount { 0 };
+		/// @brief The number of reads
+		std::uint64_t _readCount { 0 };
+		/// @brief The number of reads whose payload was identical to the previous one
+		std::uint64_t _unchangedReadCount { 0 };
+	};
+
+	/// @brief The current values. These are copied into the data block on each update.
+	State _values;
+
+	/// @brief The array element that contains the state
+	memory::Array::ObjectHandle<State> _stateHandle;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
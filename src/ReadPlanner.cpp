@@ -0,0 +1,57 @@
+// Copyright (c) embedded ocean GmbH
+#include "ReadPlanner.hpp"
+
+#include "AbstractInput.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto ReadPlanner::plan(std::span<const std::reference_wrapper<AbstractInput>> inputs) const -> std::vector<Range>
+{
+	std::vector<Range> ranges;
+
+	for (std::size_t index = 0; index < inputs.size(); ++index)
+	{
+		const auto &input = inputs[index].get();
+		const auto begin = input.address();
+		const auto end = begin + input.dataSize();
+
+		// An input cannot be split across several commands, so it must fit into a single one
+		if (input.dataSize() > _maxCommandSize)
+		{
+			/// @todo replace "template input" and "I/O transaction" with more descriptive names
+			throw std::runtime_error("a template input is larger than the maximum read size of its I/O transaction");
+		}
+
+		// Try to append the input to the current range
+		if (!ranges.empty())
+		{
+			auto &current = ranges.back();
+			const auto currentEnd = current._address + current._size;
+
+			// Inputs are sorted, so the input can only start before the end of the range if it overlaps
+			const auto gap = begin > currentEnd ? std::size_t(begin - currentEnd) : std::size_t(0);
+			const auto newEnd = std::max(end, currentEnd);
+			const auto newSize = std::size_t(newEnd - current._address);
+
+			// Reading across the gap is cheaper than an additional round trip, so merge
+			if (gap <= _maxGap && newSize <= _maxCommandSize)
+			{
+				current._size = newSize;
+				current._gapSize += gap;
+				++current._inputCount;
+				continue;
+			}
+		}
+
+		// Start a new range
+		ranges.push_back({ ._address = begin, ._size = std::size_t(end - begin), ._firstInput = index, ._inputCount = 1 });
+	}
+
+	return ranges;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,71 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+class AbstractInput;
+
+/// @brief Groups the inputs of an I/O transaction into read commands
+///
+/// The planner uses a simple gap-merge cost model: reading a byte that is not needed by any input costs one byte of
+/// bandwidth, while sending an additional command costs a full round trip. The cost of a round trip is expressed as
+/// the maximum gap, in bytes, that may be read across instead of starting a new command.
+class ReadPlanner final
+{
+public:
+	/// @brief The default maximum gap
+	/// @todo adjust this to the cost of a round trip on the actual device
+	static constexpr std::size_t kDefaultMaxGap = 32;
+	/// @brief The default maximum command size, which is unlimited.
+	/// @todo adjust this to the maximum frame size of the actual device
+	static constexpr std::size_t kDefaultMaxCommandSize = std::numeric_limits<std::size_t>::max();
+
+	/// @brief A contiguous address range that is read using a single read command
+	struct Range
+	{
+		/// @brief The address of the first byte to read
+		std::uint64_t _address { 0 };
+		/// @brief The number of bytes to read
+		std::size_t _size { 0 };
+		/// @brief The index of the first input that is read using this command
+		std::size_t _firstInput { 0 };
+		/// @brief The number of inputs that are read using this command
+		std::size_t _inputCount { 0 };
+		/// @brief The number of bytes inside the range that are not needed by any input
+		std::size_t _gapSize { 0 };
+	};
+
+	/// @brief Sets the maximum number of unused bytes that may be read across to avoid an additional command
+	auto setMaxGap(std::size_t maxGap) noexcept -> void
+	{
+		_maxGap = maxGap;
+	}
+
+	/// @brief Sets the maximum number of bytes a single command may read
+	auto setMaxCommandSize(std::size_t maxCommandSize) noexcept -> void
+	{
+		_maxCommandSize = maxCommandSize;
+	}
+
+	/// @brief Plans the read commands for a list of inputs
+	/// @param inputs The inputs to read. The inputs must be sorted by address.
+	/// @return The ranges to read. Each range refers to a contiguous subrange of *inputs*.
+	/// @throw std::runtime_error An input is larger than the maximum command size
+	auto plan(std::span<const std::reference_wrapper<AbstractInput>> inputs) const -> std::vector<Range>;
+
+private:
+	/// @brief The maximum number of unused bytes that may be read across
+	std::size_t _maxGap { kDefaultMaxGap };
+	/// @brief The maximum number of bytes a single command may read
+	std::size_t _maxCommandSize { kDefaultMaxCommandSize };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
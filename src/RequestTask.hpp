@@ -0,0 +1,91 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/process/Task.hpp>
+#include <xentara/process/ExecutionContext.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief This class providing callbacks for the Xentara scheduler for the "request" task of I/O transactions
+///
+/// The "request" task sends the read commands without waiting for the replies. The replies are received later
+/// by the "collect" task.
+template <typename Target>
+class RequestTask final : public process::Task
+{
+public:
+	/// @brief This constuctor attached the task to its target
+	RequestTask(std::reference_wrapper<Target> target) : _target(target)
+	{
+	}
+
+	/// @name Virtual Overrides for process::Task
+	/// @{
+
+	auto stages() const -> Stages final
+	{
+		return Stage::PreOperational | Stage::Operational | Stage::PostOperational;
+	}
+
+	auto preparePreOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto preOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto operational(const process::ExecutionContext &context) -> void final;
+
+	auto preparePostOperational(const process::ExecutionContext &context) -> Status final;
+
+	auto postOperational(const process::ExecutionContext &context) -> Status final;
+		
+	/// @}
+
+private:
+	/// @brief A reference to the target element
+	std::reference_wrapper<Target> _target;
+};
+
+template <typename Target>
+auto RequestTask<Target>::preparePreOperational(const process::ExecutionContext &context) -> Status
+{
+	// Send a request once, so that the "collect" task has something to initialize the value with
+	operational(context);
+
+	return Status::Ready;
+}
+
+template <typename Target>
+auto RequestTask<Target>::preOperational(const process::ExecutionContext &context) -> Status
+{
+	// We just do the same thing as in the operational stage
+	operational(context);
+
+	return Status::Ready;
+}
+
+template <typename Target>
+auto RequestTask<Target>::operational(const process::ExecutionContext &context) -> void
+{
+	_target.get().performRequestTask(context);
+}
+
+template <typename Target>
+auto RequestTask<Target>::preparePostOperational(const process::ExecutionContext &context) -> Status
+{
+	// Everything in the post operational stage is optional, so we can report ready right away
+	return Status::Ready;
+}
+
+template <typename Target>
+auto RequestTask<Target>::postOperational(const process::ExecutionContext &context) -> Status
+{
+	// We just do the same thing as in the operational stage
+	operational(context);
+
+	return Status::Ready;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -1,11 +1,22 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "TripleBuffer.hpp"
+
 #include <xentara/utils/atomic/Optional.hpp>
-#include <xentara/utils/atomic/UniquePointer.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <string>
-#include <concepts>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 
 namespace xentara::plugins::templateDriver
 {
@@ -13,6 +24,9 @@ namespace xentara::plugins::templateDriver
 /// @brief A thread-safe, lock-free queue that can hold a single value.
 ///
 /// This queues only allows enqueuing a single value. Enqueuing a second value will overwrite the first.
+///
+/// Values that fit into a lock-free atomic are stored in one. Larger trivially copyable values, like structures, 128-bit
+/// values, or a value together with a time stamp, are stored in a TripleBuffer instead, so that dequeue() remains wait-free.
 template <typename DataType>
 class SingleValueQueue final
 {
@@ -26,62 +40,192 @@ public:
 	/// @param value The value to place in the queue
 	auto enqueue(const value_type &value) noexcept -> void
 	{
-		_value.store(value, std::memory_order_release);
+		if constexpr (kIsLockFree)
+		{
+			_value.store(value, std::memory_order_release);
+		}
+		else
+		{
+			_value.store(value);
+		}
 	}
 
 	/// @brief Gets the last scheduled value and removes it from the queue
 	/// @return The scheduled value or std::nullopt if none was scheduled since the last call
 	auto dequeue() noexcept -> std::optional<value_type>
 	{
-		return _value.exchange(std::nullopt, std::memory_order_acq_rel);
+		if constexpr (kIsLockFree)
+		{
+			return _value.exchange(std::nullopt, std::memory_order_acq_rel);
+		}
+		else
+		{
+			return _value.take();
+		}
 	}
 
 private:
-	/// @brief The queued value, or std::nullopt if the queue is empty.
-	utils::atomic::Optional<value_type> _value;
+	/// @brief Whether the value can be stored in a lock-free atomic
+	static constexpr bool kIsLockFree = utils::atomic::Optional<value_type>::is_always_lock_free;
 
-	// Check that the value is lock free, or blocking will occurr
-	static_assert(decltype(_value)::is_always_lock_free);
+	// Values that are not lock-free are copied into the slots of the triple buffer
+	static_assert(kIsLockFree || std::is_trivially_copyable_v<value_type>);
+
+	/// @brief The queued value, or std::nullopt if the queue is empty.
+	std::conditional_t<kIsLockFree, utils::atomic::Optional<value_type>, TripleBuffer<value_type>> _value;
 };
 
 /// @brief Specialization of SingleValueQueue for std::basic_string<Char, Traits, Allocator>.
+///
+/// The strings are copied into a pool of preallocated slots, so neither enqueue() nor dequeue() allocate memory once
+/// reserve() has been called. One slot holds the latest value, one slot holds the value last dequeued by the consumer,
+/// and the remaining slots are used by producers to copy in new values. With three slots, this is a classic triple buffer.
+/// Additional slots allow several producers to copy strings at the same time, without having to wait for each other.
+/// Values cannot be enqueued before reserve() has been called.
 template <class Char, class Traits, class Allocator>
 class SingleValueQueue<std::basic_string<Char, Traits, Allocator>> final
 {
 public:
 	/// @brief the value type
 	using value_type = std::basic_string<Char, Traits, Allocator>;
+	/// @brief the type used to pass values in and out of the queue
+	using view_type = std::basic_string_view<Char, Traits>;
+
+	/// @brief The default maximum length of the strings
+	static constexpr std::size_t kDefaultMaxLength = 256;
+	/// @brief The default number of slots
+	static constexpr std::size_t kDefaultSlotCount = 4;
+	/// @brief The minimum number of slots
+	static constexpr std::size_t kMinSlotCount = 3;
+	/// @brief The maximum number of slots
+	static constexpr std::size_t kMaxSlotCount = 64;
+
+	/// @brief Allocates the slots.
+	///
+	/// This must be called before the queue is used, and must not be called while other threads are using the queue.
+	/// @param maxLength The maximum length of the strings that can be enqueued
+	/// @param slotCount The number of slots. This is clamped to the range kMinSlotCount to kMaxSlotCount.
+	auto reserve(std::size_t maxLength, std::size_t slotCount = kDefaultSlotCount) -> void
+	{
+		slotCount = std::clamp(slotCount, kMinSlotCount, kMaxSlotCount);
+
+		_maxLength = maxLength;
+		_storage = std::make_unique<Char[]>(maxLength * slotCount);
+		_lengths = std::make_unique<std::size_t[]>(slotCount);
+		_freeSlots.store(slotCount == kMaxSlotCount ? ~std::uint64_t(0) : (std::uint64_t(1) << slotCount) - 1, std::memory_order_relaxed);
+		_latest.store(kNoSlot, std::memory_order_relaxed);
+		_dequeued = kNoSlot;
+	}
+
+	/// @brief Gets the maximum length of the strings that can be enqueued
+	auto maxLength() const noexcept -> std::size_t
+	{
+		return _maxLength;
+	}
 
 	/// @brief Enqueues a value.
 	/// 
 	/// Any value already in the queue will be replaced.
 	/// @param value The value to place in the queue
-	template <typename... Arguments> requires std::constructible_from<value_type, Arguments &&...>
-	auto enqueue(Arguments &&... arguments) noexcept -> void
+	/// @return false if the value was longer than maxLength(), in which case it is not enqueued.
+	auto enqueue(view_type value) noexcept -> bool
 	{
-		_value.store(std::make_unique<value_type>(std::forward<Arguments>(arguments)...), std::memory_order_release);
+		// Make sure the value fits
+		if (value.size() > _maxLength || !_storage)
+		{
+			return false;
+		}
+
+		// Copy the value into a free slot
+		const auto slot = acquireSlot();
+		Traits::copy(slotData(slot), value.data(), value.size());
+		_lengths[slot] = value.size();
+
+		// Publish the slot, and free the slot holding the value it replaces
+		if (const auto replaced = _latest.exchange(slot, std::memory_order_acq_rel); replaced != kNoSlot)
+		{
+			releaseSlot(replaced);
+		}
+
+		return true;
 	}
 
 	/// @brief Gets the last scheduled value and removes it from the queue
-	/// @return The scheduled value or std::nullopt if none was scheduled since the last call
-	auto dequeue() noexcept -> std::optional<value_type>;
+	///
+	/// This function must only be called by a single consumer thread.
+	/// @return The scheduled value or std::nullopt if none was scheduled since the last call. The returned view remains
+	/// valid until the next call to dequeue().
+	auto dequeue() noexcept -> std::optional<view_type>
+	{
+		// Free the slot of the value dequeued last time
+		if (_dequeued != kNoSlot)
+		{
+			releaseSlot(_dequeued);
+		}
+
+		// Take the latest value
+		_dequeued = _latest.exchange(kNoSlot, std::memory_order_acq_rel);
+		if (_dequeued == kNoSlot)
+		{
+			return std::nullopt;
+		}
+
+		return view_type(slotData(_dequeued), _lengths[_dequeued]);
+	}
 
 private:
-	/// @brief The queued value, or std::nullopt if the queue is empty.
-	utils::atomic::UniquePointer<value_type> _value;
-};
+	/// @brief The index used to denote that there is no slot
+	static constexpr std::size_t kNoSlot = std::numeric_limits<std::size_t>::max();
 
-template <class Char, class Traits, class Allocator>
-auto SingleValueQueue<std::basic_string<Char, Traits, Allocator>>::dequeue() noexcept -> std::optional<value_type>
-{
-	if (auto value = _value.exchange(nullptr, std::memory_order_acq_rel))
+	/// @brief Gets the data of a slot
+	auto slotData(std::size_t slot) const noexcept -> Char *
 	{
-		return std::move(*value);
+		return _storage.get() + slot * _maxLength;
 	}
-	else
+
+	/// @brief Takes a free slot.
+	///
+	/// A slot only remains in use while a producer copies a value into it, so this only waits if more producers
+	/// are copying values at the same time than there are slots.
+	auto acquireSlot() noexcept -> std::size_t
+	{
+		auto freeSlots = _freeSlots.load(std::memory_order_relaxed);
+		while (true)
+		{
+			if (freeSlots == 0)
+			{
+				std::this_thread::yield();
+				freeSlots = _freeSlots.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			const auto slot = std::size_t(std::countr_zero(freeSlots));
+			if (_freeSlots.compare_exchange_weak(freeSlots, freeSlots & ~(std::uint64_t(1) << slot), std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				return slot;
+			}
+		}
+	}
+
+	/// @brief Returns a slot to the free slots
+	auto releaseSlot(std::size_t slot) noexcept -> void
 	{
-		return std::nullopt;
+		_freeSlots.fetch_or(std::uint64_t(1) << slot, std::memory_order_release);
 	}
-}
+
+	/// @brief The maximum length of the strings
+	std::size_t _maxLength { 0 };
+	/// @brief The storage for the characters of all slots
+	std::unique_ptr<Char[]> _storage;
+	/// @brief The lengths of the strings in the slots
+	std::unique_ptr<std::size_t[]> _lengths;
+
+	/// @brief The slots that are free, one bit per slot
+	std::atomic<std::uint64_t> _freeSlots { 0 };
+	/// @brief The slot holding the latest value, or kNoSlot if the queue is empty
+	std::atomic<std::size_t> _latest { kNoSlot };
+	/// @brief The slot holding the value the consumer dequeued last, or kNoSlot if there is none
+	std::size_t _dequeued { kNoSlot };
+};
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
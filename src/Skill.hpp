@@ -1,6 +1,7 @@
 // Copyright (c) embedded ocean GmbH
 #pragma once
 
+#include "TemplateArrayInput.hpp"
 #include "TemplateIoComponent.hpp"
 #include "TemplateIoTransaction.hpp"
 #include "TemplateOutput.hpp"
@@ -44,7 +45,8 @@ private:
 		TemplateIoComponent::Class,
 		TemplateIoTransaction::Class,
 		TemplateOutput::Class,
-		TemplateInput::Class>;
+		TemplateInput::Class,
+		TemplateArrayInput::Class>;
 
 	/// @brief The skill class object
 	static Class _class;
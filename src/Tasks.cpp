@@ -17,4 +17,10 @@ const process::Task::Role kRead { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "
 /// @todo assign a unique UUID
 const process::Task::Role kWrite { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "write"sv };
 
+/// @todo assign a unique UUID
+const process::Task::Role kRequest { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "request"sv };
+
+/// @todo assign a unique UUID
+const process::Task::Role kCollect { "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "collect"sv };
+
 } // namespace xentara::plugins::templateDriver::tasks
\ No newline at end of file
@@ -11,5 +11,9 @@ namespace xentara::plugins::templateDriver::tasks
 extern const process::Task::Role kRead;
 /// @brief A Xentara task used to write the data points attached to an I/O transaction
 extern const process::Task::Role kWrite;
+/// @brief A Xentara task used to send the read commands of an I/O transaction without waiting for the replies
+extern const process::Task::Role kRequest;
+/// @brief A Xentara task used to receive the replies to read commands sent by the "request" task, and update the data points
+extern const process::Task::Role kCollect;
 
 } // namespace xentara::plugins::templateDriver::tasks
\ No newline at end of file
@@ -0,0 +1,201 @@
+// Copyright (c) embedded ocean GmbH
+#include "TemplateArrayInput.hpp"
+
+#include "Attributes.hpp"
+#include "DecodeTable.hpp"
+#include "TemplateIoTransaction.hpp"
+
+#include <xentara/config/Context.hpp>
+#include <xentara/config/Errors.hpp>
+#include <xentara/data/DataType.hpp>
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/model/Attribute.hpp>
+#include <xentara/model/ForEachAttributeFunction.hpp>
+#include <xentara/model/ForEachEventFunction.hpp>
+#include <xentara/utils/json/decoder/Object.hpp>
+#include <xentara/utils/json/decoder/Errors.hpp>
+
+#include <cmath>
+#include <string>
+
+namespace xentara::plugins::templateDriver
+{
+	
+using namespace std::literals;
+
+const model::Attribute TemplateArrayInput::kValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPointArray };
+
+auto TemplateArrayInput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
+{
+	// Go through all the members of the JSON object that represents this object
+	bool ioTransactionLoaded = false;
+	bool addressLoaded = false;
+	bool lengthLoaded = false;
+	for (auto && [name, value] : jsonObject)
+    {
+		/// @todo use a more descriptive keyword, e.g. "poll"
+		if (name == "ioTransaction"sv)
+		{
+			context.resolve<TemplateIoTransaction>(value, [this](std::reference_wrapper<TemplateIoTransaction> ioTransaction)
+				{ 
+					_ioTransaction = &ioTransaction.get();
+					ioTransaction.get().addInput(*this);
+				});
+			ioTransactionLoaded = true;
+		}
+		/// @todo use a keyword that matches the device's terminology, e.g. "register"
+		else if (name == "address"sv)
+		{
+			_address = value.asNumber<std::uint64_t>();
+			addressLoaded = true;
+		}
+		else if (name == "length"sv)
+		{
+			_length = value.asNumber<std::size_t>();
+			if (_length == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("length of template array input must not be zero"));
+			}
+			lengthLoaded = true;
+		}
+		else if (name == "encoding"sv)
+		{
+			const auto encoding = parseEncoding(value.asString<std::string>());
+			if (!encoding)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown encoding in template array input"));
+			}
+			_encoding = *encoding;
+		}
+		else if (name == "scale"sv)
+		{
+			_scaling._factor = value.asNumber<double>();
+			// A scale of 0 cannot be reversed when writing, and would map every raw value to the offset when reading
+			if (!std::isfinite(_scaling._factor) || _scaling._factor == 0.0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the scale of a template array input must be finite and not 0"));
+			}
+		}
+		else if (name == "offset"sv)
+		{
+			_scaling._offset = value.asNumber<double>();
+			if (!std::isfinite(_scaling._offset))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the offset of a template array input must be finite"));
+			}
+		}
+		else
+		{
+            config::throwUnknownParameterError(name);
+		}
+    }
+
+	// Make sure that an I/O transaction was specified
+	if (!ioTransactionLoaded)
+	{
+		/// @todo replace "I/O transaction" and "template array input" with more descriptive names
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing I/O transaction in template array input"));
+	}
+	// Make sure that an address was specified
+	if (!addressLoaded)
+	{
+		/// @todo replace "template array input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing address in template array input"));
+	}
+	// Make sure that a length was specified
+	if (!lengthLoaded)
+	{
+		/// @todo replace "template array input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing length in template array input"));
+	}
+}
+
+auto TemplateArrayInput::dataType() const -> const data::DataType &
+{
+	return kValueAttribute.dataType();
+}
+
+auto TemplateArrayInput::directions() const -> io::Directions
+{
+	return io::Direction::Input;
+}
+
+auto TemplateArrayInput::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
+{
+	// forEachAttribute() must not be called before references have been resolved, so the I/O transaction should have been
+	// set already.
+	if (!_ioTransaction) [[unlikely]]
+	{
+		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateArrayInput::forEachAttribute() called before cross references have been resolved");
+	}
+
+	return
+		// Handle all the attributes we support directly
+		function(kValueAttribute) ||
+
+		// Handle the state attributes
+		_state.forEachAttribute(function) ||
+		// Also handle the common read state attributes from the I/O transaction
+		_ioTransaction->forEachReadStateAttribute(function);
+}
+
+auto TemplateArrayInput::forEachEvent(const model::ForEachEventFunction &function) -> bool
+{
+	// forEachEvent() must not be called before references have been resolved, so the I/O transaction should have been
+	// set already.
+	if (!_ioTransaction) [[unlikely]]
+	{
+		throw std::logic_error("internal error: xentara::plugins::templateDriver::TemplateArrayInput::forEachEvent() called before cross references have been resolved");
+	}
+
+	return
+		// Handle the state events
+		_state.forEachEvent(function, sharedFromThis()) ||
+		// Also handle the common read state events from the I/O transaction
+		_ioTransaction->forEachReadStateEvent(function);
+}
+
+auto TemplateArrayInput::makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle>
+{
+	// makeReadHandle() must not be called before references have been resolved, so the I/O transaction should have been
+	// set already.
+	if (!_ioTransaction) [[unlikely]]
+	{
+		// Don't throw an exception, because this function is noexcept
+		return std::make_error_code(std::errc::invalid_argument);
+	}
+	// Get the data block
+	const auto &dataBlock = _ioTransaction->readDataBlock();
+	
+	// Handle the value attribute separately
+	if (attribute == kValueAttribute)
+	{
+		return _state.valueReadHandle(dataBlock);
+	}
+	
+	// Handle the state attributes
+	if (auto handle = _state.makeReadHandle(dataBlock, attribute))
+	{
+		return handle;
+	}
+	// Also handle the common read state attributes from the I/O transaction
+	if (auto handle = _ioTransaction->makeReadStateReadHandle(attribute))
+	{
+		return handle;
+	}
+
+	return std::nullopt;
+}
+
+auto TemplateArrayInput::attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void
+{
+	_state.attach(dataArray, eventCount, _length, pass);
+}
+
+auto TemplateArrayInput::addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void
+{
+	decodeTable.addArray(_state.descriptor(payloadOffset), _encoding, _scaling);
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
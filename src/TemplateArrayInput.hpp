@@ -0,0 +1,119 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "AbstractInput.hpp"
+#include "ArrayReadState.hpp"
+#include "ValueCodec.hpp"
+
+#include <xentara/skill/DataPoint.hpp>
+#include <xentara/skill/EnableSharedFromThis.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+class TemplateIoComponent;
+class TemplateIoTransaction;
+
+/// @brief A class representing an input that reads a contiguous block of values, like e.g. a waveform or a block of registers.
+///
+/// All values are published as a single array valued attribute, and share a single change time and changed event.
+/// @todo rename this class to something more descriptive
+class TemplateArrayInput final :
+	public skill::DataPoint,
+	public AbstractInput,
+	public skill::EnableSharedFromThis<TemplateArrayInput>
+{
+public:
+	/// @brief The class object containing meta-information about this element type
+	/// @todo change class name
+	/// @todo assign a unique UUID
+	/// @todo change display name
+	using Class = ConcreteClass<"TemplateArrayInput", "deadbeef-dead-beef-dead-beefdeadbeef"_uuid, "template driver array input">;
+
+	/// @brief This constructor attaches the input to its I/O component
+	TemplateArrayInput(std::reference_wrapper<TemplateIoComponent> ioComponent) :
+		_ioComponent(ioComponent)
+	{
+	}
+
+	/// @name Virtual Overrides for skill::DataPoint
+	/// @{
+	
+	auto dataType() const -> const data::DataType & final;
+
+	auto directions() const -> io::Directions final;
+
+	auto forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool final;
+
+	auto forEachEvent(const model::ForEachEventFunction &function) -> bool final;
+
+	auto makeReadHandle(const model::Attribute &attribute) const noexcept -> std::optional<data::ReadHandle> final;
+
+	/// @}
+
+	/// @name Virtual Overrides for AbstractInput
+	/// @{
+
+	auto ioComponent() const -> const TemplateIoComponent & final
+	{
+		return _ioComponent;
+	}
+
+	auto address() const noexcept -> std::uint64_t final
+	{
+		return _address;
+	}
+
+	auto dataSize() const noexcept -> std::size_t final
+	{
+		return _length * encodedSize(_encoding, sizeof(double));
+	}
+	
+	auto attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void final;
+
+	auto addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void final;
+		
+	/// @}
+
+	/// @brief A Xentara attribute containing the current values of the input.
+	/// @note This is a member of this class rather than of the attributes namespace, because the access flags
+	/// and type may differ from class to class
+	static const model::Attribute kValueAttribute;
+
+private:
+	/// @name Virtual Overrides for skill::DataPoint
+	/// @{
+
+	auto load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void final;
+
+	/// @}
+
+	/// @brief The I/O component this input belongs to
+	/// @todo give this a more descriptive name, e.g. "_device"
+	std::reference_wrapper<TemplateIoComponent> _ioComponent;
+
+	/// @brief The I/O transaction this input belongs to, or nullptr if it hasn't been loaded yet.
+	/// @todo give this a more descriptive name, e.g. "_poll"
+	TemplateIoTransaction *_ioTransaction { nullptr };
+
+	/// @brief The address of the first value on the I/O component
+	std::uint64_t _address { 0 };
+	/// @brief The number of values
+	std::size_t _length { 0 };
+	/// @brief The encoding of the values on the I/O component
+	Encoding _encoding { Encoding::Native };
+	/// @brief The scaling to apply to the raw values
+	Scaling _scaling;
+
+	/// @brief The state
+	ArrayReadState _state;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "TemplateInput.hpp"
 
 #include "Attributes.hpp"
+#include "DecodeTable.hpp"
 #include "TemplateIoTransaction.hpp"
 
 #include <xentara/config/Context.hpp>
@@ -15,17 +16,26 @@
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
 
+#include <cmath>
+#include <string>
+#include <variant>
+
 namespace xentara::plugins::templateDriver
 {
 	
 using namespace std::literals;
 
-const model::Attribute TemplateInput::kValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
+const model::Attribute TemplateInput::kBooleanValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadOnly, data::DataType::kBoolean };
+
+const model::Attribute TemplateInput::kIntegerValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadOnly, data::DataType::kInteger };
+
+const model::Attribute TemplateInput::kFloatingPointValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadOnly, data::DataType::kFloatingPoint };
 
 auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
 	// Go through all the members of the JSON object that represents this object
 	bool ioTransactionLoaded = false;
+	bool addressLoaded = false;
 	for (auto && [name, value] : jsonObject)
     {
 		/// @todo use a more descriptive keyword, e.g. "poll"
@@ -38,6 +48,71 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 				});
 			ioTransactionLoaded = true;
 		}
+		/// @todo use a keyword that matches the device's terminology, e.g. "register"
+		else if (name == "address"sv)
+		{
+			_address = value.asNumber<std::uint64_t>();
+			addressLoaded = true;
+		}
+		else if (name == "dataType"sv)
+		{
+			const auto valueType = parseValueType(value.asString<std::string>());
+			if (!valueType)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown data type in template input"));
+			}
+			_valueType = *valueType;
+		}
+		else if (name == "encoding"sv)
+		{
+			const auto encoding = parseEncoding(value.asString<std::string>());
+			if (!encoding)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown encoding in template input"));
+			}
+			_encoding = *encoding;
+		}
+		else if (name == "scale"sv)
+		{
+			_scaling._factor = value.asNumber<double>();
+			// A scale of 0 cannot be reversed when writing, and would map every raw value to the offset when reading
+			if (!std::isfinite(_scaling._factor) || _scaling._factor == 0.0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the scale of a template input must be finite and not 0"));
+			}
+		}
+		else if (name == "offset"sv)
+		{
+			_scaling._offset = value.asNumber<double>();
+			if (!std::isfinite(_scaling._offset))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the offset of a template input must be finite"));
+			}
+		}
+		else if (name == "deadband"sv)
+		{
+			_deadband._absolute = value.asNumber<double>();
+			if (!(_deadband._absolute >= 0.0))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("negative deadband in template input"));
+			}
+		}
+		else if (name == "relativeDeadband"sv)
+		{
+			_deadband._relative = value.asNumber<double>();
+			if (!(_deadband._relative >= 0.0))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("negative relative deadband in template input"));
+			}
+		}
+		else if (name == "hysteresis"sv)
+		{
+			_deadband._hysteresis = value.asNumber<double>();
+			if (!(_deadband._hysteresis >= 0.0))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("negative hysteresis in template input"));
+			}
+		}
 		/// @todo load custom configuration parameters
 		else if (name == "TODO"sv)
 		{
@@ -65,17 +140,46 @@ auto TemplateInput::load(utils::json::decoder::Object &jsonObject, config::Conte
 		/// @todo replace "I/O transaction" and "template input" with more descriptive names
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing I/O transaction in template input"));
 	}
+	// Make sure that an address was specified
+	if (!addressLoaded)
+	{
+		/// @todo replace "template input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing address in template input"));
+	}
+	// Boolean values cannot have a deadband
+	if (_valueType == ValueType::Boolean && !_deadband.isNone())
+	{
+		/// @todo replace "template input" with a more descriptive name
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("deadband specified for boolean template input"));
+	}
 	/// @todo perform consistency and completeness checks
 	if (!"TODO")
 	{
 		/// @todo use an error message that tells the user exactly what is wrong
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("TODO is wrong with template input"));
 	}
+
+	// Create the state for the correct value type
+	emplaceValueType(_state, _valueType);
+}
+
+auto TemplateInput::valueAttribute() const noexcept -> const model::Attribute &
+{
+	switch (_valueType)
+	{
+	case ValueType::Boolean:
+		return kBooleanValueAttribute;
+	case ValueType::Float:
+	case ValueType::Double:
+		return kFloatingPointValueAttribute;
+	default:
+		return kIntegerValueAttribute;
+	}
 }
 
 auto TemplateInput::dataType() const -> const data::DataType &
 {
-	return kValueAttribute.dataType();
+	return valueAttribute().dataType();
 }
 
 auto TemplateInput::directions() const -> io::Directions
@@ -94,10 +198,10 @@ auto TemplateInput::forEachAttribute(const model::ForEachAttributeFunction &func
 
 	return
 		// Handle all the attributes we support directly
-		function(kValueAttribute) ||
+		function(valueAttribute()) ||
 
 		// Handle the state attributes
-		_state.forEachAttribute(function) ||
+		std::visit([&](const auto &state) { return state.forEachAttribute(function); }, _state) ||
 		// Also handle the common read state attributes from the I/O transaction
 		_ioTransaction->forEachReadStateAttribute(function);
 
@@ -115,7 +219,7 @@ auto TemplateInput::forEachEvent(const model::ForEachEventFunction &function) ->
 
 	return
 		// Handle the state events
-		_state.forEachEvent(function, sharedFromThis()) ||
+		std::visit([&](auto &state) { return state.forEachEvent(function, sharedFromThis()); }, _state) ||
 		// Also handle the common read state events from the I/O transaction
 		_ioTransaction->forEachReadStateEvent(function);
 
@@ -135,13 +239,13 @@ auto TemplateInput::makeReadHandle(const model::Attribute &attribute) const noex
 	const auto &dataBlock = _ioTransaction->readDataBlock();
 	
 	// Handle the value attribute separately
-	if (attribute == kValueAttribute)
+	if (attribute == valueAttribute())
 	{
-		return _state.valueReadHandle(dataBlock);
+		return std::visit([&](const auto &state) { return state.valueReadHandle(dataBlock); }, _state);
 	}
 	
 	// Handle the state attributes
-	if (auto handle = _state.makeReadHandle(dataBlock, attribute))
+	if (auto handle = std::visit([&](const auto &state) { return state.makeReadHandle(dataBlock, attribute); }, _state))
 	{
 		return handle;
 	}
@@ -156,32 +260,16 @@ auto TemplateInput::makeReadHandle(const model::Attribute &attribute) const noex
 	return std::nullopt;
 }
 
-auto TemplateInput::attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void
+auto TemplateInput::attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void
 {
-	_state.attach(dataArray, eventCount);
+	std::visit([&](auto &state) { state.attach(dataArray, eventCount, pass); }, _state);
 }
 
-auto TemplateInput::updateReadState(WriteSentinel &writeSentinel,
-	std::chrono::system_clock::time_point timeStamp,
-	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
-	const CommonReadState::Changes &commonChanges,
-	PendingEventList &eventsToRaise) -> void
+auto TemplateInput::addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void
 {
-	// Check if we have a valid payload
-	if (payloadOrError)
-	{
-		/// @todo decode the value from the payload data
-		double value = {};
-
-		// Update the state
-		_state.update(writeSentinel, timeStamp, value, commonChanges, eventsToRaise);
-	}
-	// We have an error
-	else
-	{
-		// Update the state with the error
-		_state.update(writeSentinel, timeStamp, utils::eh::unexpected(payloadOrError.error()), commonChanges, eventsToRaise);
-	}
+	std::visit([&]<typename DataType>(PerValueReadState<DataType> &state)
+		{ decodeTable.add<DataType>(state.descriptor(payloadOffset), _encoding, _scaling, _deadband); },
+		_state);
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -2,11 +2,15 @@
 #pragma once
 
 #include "AbstractInput.hpp"
+#include "Deadband.hpp"
 #include "PerValueReadState.hpp"
+#include "ValueCodec.hpp"
+#include "ValueType.hpp"
 
 #include <xentara/skill/DataPoint.hpp>
 #include <xentara/skill/EnableSharedFromThis.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <string_view>
 
@@ -57,23 +61,36 @@ public:
 	{
 		return _ioComponent;
 	}
+
+	auto address() const noexcept -> std::uint64_t final
+	{
+		return _address;
+	}
+
+	auto dataSize() const noexcept -> std::size_t final
+	{
+		return encodedSize(_encoding, valueSize(_valueType));
+	}
 	
-	auto attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void final;
+	auto attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void final;
 
-	auto updateReadState(WriteSentinel &writeSentinel,
-		std::chrono::system_clock::time_point timeStamp,
-		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
-		const CommonReadState::Changes &commonChanges,
-		PendingEventList &eventsToRaise) -> void final;
+	auto addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void final;
 		
 	/// @}
 
-	/// @brief A Xentara attribute containing the current value.
+	/// @brief A Xentara attribute containing the current value of a boolean input.
 	/// @note This is a member of this class rather than of the attributes namespace, because the access flags
 	/// and type may differ from class to class
-	static const model::Attribute kValueAttribute;
+	static const model::Attribute kBooleanValueAttribute;
+	/// @brief A Xentara attribute containing the current value of an integer input.
+	static const model::Attribute kIntegerValueAttribute;
+	/// @brief A Xentara attribute containing the current value of a floating point input.
+	static const model::Attribute kFloatingPointValueAttribute;
 
 private:
+	/// @brief Gets the value attribute that matches the value type
+	auto valueAttribute() const noexcept -> const model::Attribute &;
+
 	/// @name Virtual Overrides for skill::DataPoint
 	/// @{
 
@@ -89,12 +106,19 @@ private:
 	/// @todo give this a more descriptive name, e.g. "_poll"
 	TemplateIoTransaction *_ioTransaction { nullptr };
 
-	/// @class xentara::plugins::templateDriver::TemplateInput
-	/// @todo add information needed to decode the value from the payload of a read command, like e.g. a data offset.
-
-	/// @brief The state
-	/// @todo use the correct value type
-	PerValueReadState<double> _state;
+	/// @brief The type of the value
+	ValueType _valueType { ValueType::Double };
+	/// @brief The address of the value on the I/O component
+	std::uint64_t _address { 0 };
+	/// @brief The encoding of the value on the I/O component
+	Encoding _encoding { Encoding::Native };
+	/// @brief The scaling to apply to the raw value
+	Scaling _scaling;
+	/// @brief The deadband used to suppress small changes of the value
+	Deadband _deadband;
+
+	/// @brief The state, which holds a value of the type selected by _valueType
+	ValueTypeVariant<PerValueReadState> _state;
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
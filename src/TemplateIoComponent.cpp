@@ -3,6 +3,7 @@
 
 #include "Attributes.hpp"
 #include "TemplateIoTransaction.hpp"
+#include "TemplateArrayInput.hpp"
 #include "TemplateInput.hpp"
 #include "TemplateOutput.hpp"
 
@@ -14,6 +15,9 @@
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -26,8 +30,47 @@ auto TemplateIoComponent::load(utils::json::decoder::Object &jsonObject, config:
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
+		if (name == "queueDepth"sv)
+		{
+			_queueDepth = value.asNumber<unsigned>();
+			if (_queueDepth == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the queue depth of a template I/O component must not be 0"));
+			}
+		}
+		else if (name == "responseTimeout"sv)
+		{
+			const auto timeout = std::chrono::duration<double, std::milli>(value.asNumber<double>());
+			if (timeout.count() <= 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the response timeout of a template I/O component must be positive"));
+			}
+			_responseTimeout = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout);
+		}
+		else if (name == "readCoalescingWindow"sv)
+		{
+			const auto window = std::chrono::duration<double, std::milli>(value.asNumber<double>());
+			if (window.count() < 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the read coalescing window of a template I/O component must not be negative"));
+			}
+			_readCoalescer.setWindow(std::chrono::duration_cast<std::chrono::nanoseconds>(window));
+		}
+		else if (name == "maxCoalescedReadGap"sv)
+		{
+			_readCoalescer.setMaxGap(value.asNumber<std::size_t>());
+		}
+		else if (name == "maxCoalescedReadSize"sv)
+		{
+			const auto maxReadSize = value.asNumber<std::size_t>();
+			if (maxReadSize == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the maximum coalesced read size of a template I/O component must not be 0"));
+			}
+			_readCoalescer.setMaxCommandSize(maxReadSize);
+		}
 		/// @todo load configuration parameters
-		if (name == "TODO"sv)
+		else if (name == "TODO"sv)
 		{
 			/// @todo parse the value correctly
 			auto todo = value.asNumber<std::uint64_t>();
@@ -62,6 +105,10 @@ auto TemplateIoComponent::createChildElement(const skill::Element::Class &elemen
 	{
 		return factory.makeShared<TemplateInput>(*this);
 	}
+	else if (&elementClass == &TemplateArrayInput::Class::instance())
+	{
+		return factory.makeShared<TemplateArrayInput>(*this);
+	}
 	else if (&elementClass == &TemplateOutput::Class::instance())
 	{
 		return factory.makeShared<TemplateOutput>(*this);
@@ -91,14 +138,83 @@ auto TemplateIoComponent::makeReadHandle(const model::Attribute &attribute) cons
 	return std::nullopt;
 }
 
+auto TemplateIoComponent::registerReceiveBuffer(std::size_t size) -> std::span<std::byte>
+{
+	// Allocate the buffer. The buffer is zero-initialized, so that it holds defined data before the first read.
+	auto &storage = _receiveBuffers.emplace_back(std::make_unique<std::byte[]>(size));
+	const std::span buffer(storage.get(), size);
+
+	// Register it with the I/O component
+	_handle.registerReceiveBuffer(buffer);
+
+	return buffer;
+}
+
+auto TemplateIoComponent::addCoalescedReads(std::span<const ReadPlanner::Range> ranges) -> std::size_t
+{
+	std::scoped_lock lock(_readCoalescerMutex);
+
+	return _readCoalescer.addParticipant(ranges);
+}
+
+auto TemplateIoComponent::coalescedRead(std::size_t participant, std::chrono::system_clock::time_point timeStamp,
+	std::span<ReadCommand *const> commands) noexcept -> std::error_code
+{
+	// Another I/O transaction may read the combined commands again at any time, so hold the lock until the data
+	// has been copied out of them
+	std::scoped_lock lock(_readCoalescerMutex);
+
+	// Read the combined commands, unless another I/O transaction has already done so within the coalescing window
+	if (!_readCoalescer.isCurrent(timeStamp))
+	{
+		// Send all the combined commands, stopping at the first error
+		std::error_code error;
+		for (auto &&command : _readCoalescer.commands())
+		{
+			if (const auto result = _handle.read(*command); !result)
+			{
+				error = result.error();
+				break;
+			}
+		}
+
+		_readCoalescer.setResult(timeStamp, error);
+	}
+
+	// Check for errors
+	if (const auto error = _readCoalescer.lastError())
+	{
+		return error;
+	}
+
+	// Fan the data out to the I/O transaction
+	_readCoalescer.receive(participant, commands);
+
+	return {};
+}
+
 auto TemplateIoComponent::prepare() -> void
 {
+#if defined(__linux__)
+	/// @todo open the I/O device, and get a file descriptor for it
+	const int fileDescriptor = -1;
+
+	// Open the handle
+	_handle.open(fileDescriptor, _queueDepth, _responseTimeout);
+#else
 	/// @todo open the handle for the I/O device
+#endif
 }
 
 auto TemplateIoComponent::cleanup() -> void
 {
-	/// @todo close the handle to the I/O device
+	// Close the handle. This must be done before the receive buffers are released, because there may still be
+	// reads in flight.
+	_handle.close();
+
+	// Release the receive buffers
+	_readCoalescer.clear();
+	_receiveBuffers.clear();
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -3,14 +3,28 @@
 
 #include "Attributes.hpp"
 #include "CustomError.hpp"
+#include "IoHandle.hpp"
+#include "ReadCoalescer.hpp"
+#include "ReadCommand.hpp"
+#include "ReadPlanner.hpp"
+#include "WriteCommand.hpp"
 
 #include <xentara/model/ElementCategory.hpp>
 #include <xentara/skill/Element.hpp>
 #include <xentara/utils/core/Uuid.hpp>
+#include <xentara/utils/eh/expected.hpp>
 #include <xentara/utils/tools/Unique.hpp>
 
 #include <string_view>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <vector>
 
 namespace xentara::plugins::templateDriver
 {
@@ -31,10 +45,7 @@ public:
 		"template driver I/O component">;
 
 	/// @brief A handle used to access the I/O component
-	/// @todo implement a proper handle
-	class Handle final : private utils::tools::Unique
-	{
-	};
+	using Handle = IoHandle;
 
 	/// @brief Returns a handle to the I/O component
 	auto handle() const -> const Handle &
@@ -42,6 +53,40 @@ public:
 		return _handle;
 	}
 
+	/// @brief Allocates a buffer that data can be received into and registers it with the I/O component
+	///
+	/// This must be called before the I/O component is used to read data, e.g. when an I/O transaction is prepared.
+	/// @param size The size of the buffer, in bytes
+	/// @return The buffer. The buffer remains valid until the I/O component is cleaned up.
+	auto registerReceiveBuffer(std::size_t size) -> std::span<std::byte>;
+
+	/// @brief Adds the address ranges of an I/O transaction to the combined read commands
+	///
+	/// This must be called when the I/O transaction is prepared.
+	/// @param ranges The address ranges the I/O transaction reads
+	/// @return An index that identifies the I/O transaction in calls to coalescedRead()
+	auto addCoalescedReads(std::span<const ReadPlanner::Range> ranges) -> std::size_t;
+
+	/// @brief Gets the window within which the reads of several I/O transactions are served from the same combined read commands
+	///
+	/// A window of zero means that reads are not coalesced.
+	auto readCoalescingWindow() const noexcept -> std::chrono::nanoseconds
+	{
+		return _readCoalescer.window();
+	}
+
+	/// @brief Gets the data of an I/O transaction from the combined read commands
+	///
+	/// The combined read commands are only sent if they have not been read within the coalescing window. Otherwise,
+	/// the data is taken from the last reply.
+	/// @param participant The index returned by addCoalescedReads()
+	/// @param timeStamp The time stamp of the read
+	/// @param commands The read commands of the I/O transaction, one for each of its address ranges. The data is copied into
+	/// the receive buffers of the commands, so that it remains valid after the combined commands have been read again.
+	/// @return The read error, or a default constructed std::error_code object if the data was read successfully.
+	auto coalescedRead(std::size_t participant, std::chrono::system_clock::time_point timeStamp,
+		std::span<ReadCommand *const> commands) noexcept -> std::error_code;
+
 	/// @name Virtual Overrides for skill::Element
 	/// @{
 
@@ -70,8 +115,25 @@ private:
 
 	/// @}
 
+	/// @brief The default value for the maximum number of commands that can be in flight at the same time
+	static constexpr unsigned kDefaultQueueDepth = 64;
+
+	/// @brief The maximum number of commands that can be in flight at the same time
+	unsigned _queueDepth { kDefaultQueueDepth };
+
+	/// @brief How long to wait for the I/O component to answer a command before it is cancelled
+	std::chrono::nanoseconds _responseTimeout { IoHandle::kDefaultTimeout };
+
 	/// @brief A handle to the I/O component
 	Handle _handle;
+
+	/// @brief The combined read commands for I/O transactions that coalesce their reads
+	ReadCoalescer _readCoalescer;
+	/// @brief Protects access to the combined read commands, which are shared by all I/O transactions
+	std::mutex _readCoalescerMutex;
+
+	/// @brief The receive buffers that were allocated and registered with the I/O component
+	std::vector<std::unique_ptr<std::byte[]>> _receiveBuffers;
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
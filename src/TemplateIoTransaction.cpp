@@ -3,9 +3,11 @@
 
 #include "Attributes.hpp"
 #include "Tasks.hpp"
+#include "TemplateIoComponent.hpp"
 #include "TemplateInput.hpp"
 #include "TemplateOutput.hpp"
 #include "WriteCommand.hpp"
+#include "WriteCommandBuilder.hpp"
 
 #include <xentara/config/Context.hpp>
 #include <xentara/config/Errors.hpp>
@@ -20,7 +22,15 @@
 #include <xentara/process/ExecutionContext.hpp>
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
-#include <xentara/utils/eh/currentErrorCode.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
 
 namespace xentara::plugins::templateDriver
 {
@@ -53,8 +63,82 @@ auto TemplateIoTransaction::load(utils::json::decoder::Object &jsonObject, confi
 	// Go through all the members of the JSON object that represents this object
 	for (auto && [name, value] : jsonObject)
     {
+		if (name == "maxReadGap"sv)
+		{
+			_readPlanner.setMaxGap(value.asNumber<std::size_t>());
+		}
+		else if (name == "maxReadSize"sv)
+		{
+			const auto maxReadSize = value.asNumber<std::size_t>();
+			if (maxReadSize == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the maximum read size of a template I/O transaction must not be 0"));
+			}
+			_readPlanner.setMaxCommandSize(maxReadSize);
+		}
+		else if (name == "maxWriteGap"sv)
+		{
+			_writeCommandBuilder.setMaxGap(value.asNumber<std::size_t>());
+		}
+		else if (name == "maxWriteSize"sv)
+		{
+			const auto maxWriteSize = value.asNumber<std::size_t>();
+			if (maxWriteSize == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the maximum write size of a template I/O transaction must not be 0"));
+			}
+			_writeCommandBuilder.setMaxCommandSize(maxWriteSize);
+		}
+		else if (name == "maxWriteRounds"sv)
+		{
+			_maxWriteRounds = value.asNumber<std::size_t>();
+			if (_maxWriteRounds == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the maximum number of write rounds of a template I/O transaction must not be 0"));
+			}
+		}
+		else if (name == "wakeOnWrite"sv)
+		{
+			_wakeOnWrite = value.asBool();
+		}
+		else if (name == "minWriteInterval"sv)
+		{
+			const auto interval = std::chrono::duration<double, std::milli>(value.asNumber<double>());
+			if (interval.count() < 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the minimum write interval of a template I/O transaction must not be negative"));
+			}
+			_minWriteInterval = std::chrono::duration_cast<std::chrono::nanoseconds>(interval);
+		}
+		else if (name == "coalesceReads"sv)
+		{
+			_coalesceReads = value.asBool();
+		}
+		else if (name == "dataLayout"sv)
+		{
+			const auto dataLayout = parseDataLayout(value.asString<std::string>());
+			if (!dataLayout)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown data layout in template I/O transaction"));
+			}
+			_dataLayout = *dataLayout;
+		}
+		else if (name == "inputEvents"sv)
+		{
+			_raiseInputEvents = value.asBool();
+		}
+		else if (name == "readVersions"sv)
+		{
+			_readVersionCount = value.asNumber<std::size_t>();
+			if (_readVersionCount != 0 &&
+				(_readVersionCount < VersionedBuffer::kMinSlotCount || _readVersionCount > VersionedBuffer::kMaxSlotCount))
+			{
+				utils::json::decoder::throwWithLocation(value,
+					std::runtime_error("the number of read versions of a template I/O transaction must be 0, or between 2 and 64"));
+			}
+		}
 		/// @todo load configuration parameters
-		if (name == "TODO"sv)
+		else if (name == "TODO"sv)
 		{
 			/// @todo parse the value correctly
 			auto todo = value.asNumber<std::uint64_t>();
@@ -95,7 +179,7 @@ auto TemplateIoTransaction::addInput(std::reference_wrapper<AbstractInput> input
 	_inputs.push_back(input);
 }
 
-auto TemplateIoTransaction::addOutput(std::reference_wrapper<AbstractOutput> output) -> void
+auto TemplateIoTransaction::addOutput(std::reference_wrapper<AbstractOutput> output) -> std::size_t
 {
 	// Make sure we belong to the same I/O component
 	if (&output.get().ioComponent() != &_ioComponent.get())
@@ -106,6 +190,8 @@ auto TemplateIoTransaction::addOutput(std::reference_wrapper<AbstractOutput> out
 
 	// Add it
 	_outputs.push_back(output);
+
+	return _outputs.size() - 1;
 }
 
 auto TemplateIoTransaction::forEachAttribute(const model::ForEachAttributeFunction &function) const -> bool
@@ -113,6 +199,10 @@ auto TemplateIoTransaction::forEachAttribute(const model::ForEachAttributeFuncti
 	return
 		// Handle the read state attributes
 		_readState.forEachAttribute(function) ||
+		// Handle the read diagnostics attributes
+		_readDiagnostics.forEachAttribute(function) ||
+		// Handle the changed input attributes
+		_changedInputs.forEachAttribute(function) ||
 		// Handle the write state attributes
 		_writeState.forEachAttribute(function);
 
@@ -124,6 +214,8 @@ auto TemplateIoTransaction::forEachEvent(const model::ForEachEventFunction &func
 	return
 		// Handle the read state events
 		_readState.forEachEvent(function, sharedFromThis()) ||
+		// Handle the changed input events
+		_changedInputs.forEachEvent(function, sharedFromThis()) ||
 		// Handle the write state events
 		_writeState.forEachEvent(function, sharedFromThis());
 
@@ -135,7 +227,9 @@ auto TemplateIoTransaction::forEachTask(const model::ForEachTaskFunction &functi
 	// Handle all the tasks we support
 	return
 		function(tasks::kRead, sharedFromThis(&_readTask)) ||
-		function(tasks::kWrite, sharedFromThis(&_writeTask));
+		function(tasks::kWrite, sharedFromThis(&_writeTask)) ||
+		function(tasks::kRequest, sharedFromThis(&_requestTask)) ||
+		function(tasks::kCollect, sharedFromThis(&_collectTask));
 
 	/// @todo handle any additional tasks this class supports
 }
@@ -147,6 +241,16 @@ auto TemplateIoTransaction::makeReadHandle(const model::Attribute &attribute) co
 	{
 		return handle;
 	}
+	// Handle the read diagnostics attributes
+	if (auto handle = _readDiagnostics.makeReadHandle(_readDataBlock, attribute))
+	{
+		return handle;
+	}
+	// Handle the changed input attributes
+	if (auto handle = _changedInputs.makeReadHandle(_readDataBlock, attribute))
+	{
+		return handle;
+	}
 	// Handle the write state attributes
 	if (auto handle = _writeState.makeReadHandle(_writeDataBlock, attribute))
 	{
@@ -182,17 +286,78 @@ auto TemplateIoTransaction::realize() -> void
 
 	// Add our own states
 	_readState.attach(_readDataArray, readEventCount);
+	_readDiagnostics.attach(_readDataArray);
+	_changedInputs.attach(_readDataArray, readEventCount, _inputs.size());
 	_writeState.attach(_writeDataArray, writeEventCount);
 
-	// Attach all the inputs
-	for (auto &&input : _inputs)
+	// Coalescing reads only pays off if several reads are served from the same reply. Without a window, every read would
+	// read the combined commands of all I/O transactions again.
+	if (_coalesceReads && _ioComponent.get().readCoalescingWindow() == std::chrono::nanoseconds::zero())
 	{
-		input.get().attachInput(_readDataArray, readEventCount);
+		/// @todo replace "template I/O transaction" and "template I/O component" with more descriptive names
+		throw std::runtime_error("a template I/O transaction coalesces its reads, but its template I/O component has no read coalescing window");
+	}
+
+	// Sort the inputs by address, so that the read planner can group them into read commands. Attaching the
+	// inputs in this order also means that the inputs of each read command occupy a contiguous range of the read data block.
+	// Remember the order the inputs were added in, so that the bitmap of changed inputs can use it.
+	_inputNumbers.resize(_inputs.size());
+	std::iota(_inputNumbers.begin(), _inputNumbers.end(), std::size_t(0));
+	std::ranges::stable_sort(_inputNumbers, {}, [this](std::size_t number) { return _inputs[number].get().address(); });
+	std::vector<std::reference_wrapper<AbstractInput>> sortedInputs;
+	sortedInputs.reserve(_inputs.size());
+	for (auto &&number : _inputNumbers)
+	{
+		sortedInputs.push_back(_inputs[number]);
+	}
+	_inputs = std::move(sortedInputs);
+
+	// Plan the read commands
+	_readPlan = _readPlanner.plan(_inputs);
+
+	// Publish the read plan through the diagnostics
+	std::size_t readByteCount { 0 };
+	std::size_t readGapByteCount { 0 };
+	for (auto &&range : _readPlan)
+	{
+		readByteCount += range._size;
+		readGapByteCount += range._gapSize;
+	}
+	_readDiagnostics.setReadPlan(_readPlan.size(), readByteCount, readGapByteCount);
+
+	// Attach all the inputs. For the column layout, all the values are attached first, followed by everything else.
+	if (_dataLayout == DataLayout::Columns)
+	{
+		for (auto &&input : _inputs)
+		{
+			input.get().attachInput(_readDataArray, readEventCount, AttachPass::Values);
+		}
+		for (auto &&input : _inputs)
+		{
+			input.get().attachInput(_readDataArray, readEventCount, AttachPass::Metadata);
+		}
 	}
-	// Attach all the outputs
+	else
+	{
+		for (auto &&input : _inputs)
+		{
+			input.get().attachInput(_readDataArray, readEventCount, AttachPass::All);
+		}
+	}
+	// Attach all the outputs, and add them to the write command builder
 	for (auto &&output : _outputs)
 	{
 		output.get().attachOutput(_writeDataArray, writeEventCount);
+		_writeCommandBuilder.addOutput(output.get().address(), output.get().dataSize());
+	}
+	// This rejects outputs with overlapping addresses
+	_writeCommandBuilder.compile();
+	_pendingOutputs.reset(_outputs.size());
+
+	// Allocate the versions of the inputs, if requested
+	if (_readVersionCount != 0)
+	{
+		_inputSnapshots.reset(InputSnapshot::size(_inputs.size()), _readVersionCount);
 	}
 
 	// Create the data blocks
@@ -200,17 +365,75 @@ auto TemplateIoTransaction::realize() -> void
 	_writeDataBlock.create(memory::memoryResources::data());
 
 	// Reserve space in the buffers
-	_runtimeBuffers._eventsToRaise.reset(std::max(readEventCount, writeEventCount));
+	_runtimeBuffers._readEventsToRaise.reset(readEventCount);
+	_runtimeBuffers._writeEventsToRaise.reset(writeEventCount);
 	_runtimeBuffers._outputsToNotify.reset(_outputs.size());
 }
 
 auto TemplateIoTransaction::prepare() -> void
 {
-	// Create a read command
-	/// @todo initialized the read command properly based on the inputs to read.
-	_readCommand.reset(new ReadCommand);
+	// If we coalesce our reads with other transactions, the I/O component reads the data for us using its combined commands.
+	if (_coalesceReads)
+	{
+		_readParticipant = _ioComponent.get().addCoalescedReads(_readPlan);
+	}
+
+	// Allocate two receive buffers large enough to hold the data of all the read commands. The buffers are used alternately,
+	// so that the previous payload of each command stays valid while the next one is received. Coalesced reads copy their
+	// data into these buffers, too.
+	std::size_t receiveSize = 0;
+	for (auto &&range : _readPlan)
+	{
+		receiveSize += range._size;
+	}
+	const auto firstBuffer = _ioComponent.get().registerReceiveBuffer(receiveSize);
+	const auto secondBuffer = _ioComponent.get().registerReceiveBuffer(receiveSize);
+
+	// Create a read command for each planned range
+	_readOperations.clear();
+	_readOperations.reserve(_readPlan.size());
+	_coalescedCommands.clear();
+	_coalescedCommands.reserve(_readPlan.size());
+	std::size_t bufferOffset = 0;
+	for (auto &&range : _readPlan)
+	{
+		/// @todo initialize the read command with any additional information the I/O component needs.
+		auto &operation = _readOperations.emplace_back(std::make_unique<ReadCommand>(range._address, range._size));
+
+		// Give the command its own section of the receive buffers
+		operation._command->assignReceiveBuffers(
+			firstBuffer.subspan(bufferOffset, range._size), secondBuffer.subspan(bufferOffset, range._size));
+		bufferOffset += range._size;
+		if (_coalesceReads)
+		{
+			_coalescedCommands.push_back(operation._command.get());
+		}
+
+		// Compile the decode table for the inputs read by this command
+		operation._decodeTable.setInputNumbers(std::span<const std::size_t>(_inputNumbers).subspan(range._firstInput, range._inputCount));
+		for (auto &&input : std::span(_inputs).subspan(range._firstInput, range._inputCount))
+		{
+			input.get().addToDecodeTable(operation._decodeTable, std::size_t(input.get().address() - range._address));
+		}
+	}
+
+	// Start the writer thread, if required
+	if (_wakeOnWrite)
+	{
+		_writerThread = std::jthread([this](std::stop_token stopToken) { runWriter(stopToken); });
+	}
+}
 
-	/// @todo provide the information needed to decode the value to the inputs, like e.g. the correct data data offsets.
+auto TemplateIoTransaction::cleanup() -> void
+{
+	// Stop the writer thread. The thread has to be woken up, so it notices the stop request.
+	if (_writerThread.joinable())
+	{
+		_writerThread.request_stop();
+		_writerWakeup.store(true, std::memory_order_release);
+		_writerWakeup.notify_one();
+		_writerThread.join();
+	}
 }
 
 auto TemplateIoTransaction::performReadTask(const process::ExecutionContext &context) -> void
@@ -220,24 +443,131 @@ auto TemplateIoTransaction::performReadTask(const process::ExecutionContext &con
 
 auto TemplateIoTransaction::read(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	try
+	// Let the I/O component read the data if we coalesce our reads with other transactions
+	if (_coalesceReads)
+	{
+		readCoalesced(timeStamp);
+		return;
+	}
+
+	const auto &handle = _ioComponent.get().handle();
+
+	// Send all the read commands, stopping at the first error. No exceptions are used here, so that a failing
+	// I/O component does not cause stack unwinding on every cycle. Each read is finished before the next one is sent,
+	// so no read is left in flight if an error occurs.
+	std::error_code error;
+	for (auto &&operation : _readOperations)
+	{
+		if (const auto result = handle.read(*operation._command); !result)
+		{
+			error = result.error();
+			break;
+		}
+	}
+
+	// Update the state
+	updateInputs(timeStamp, error);
+}
+
+auto TemplateIoTransaction::readCoalesced(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Get our part of the data from the combined read commands of the I/O component. The data is copied into our own
+	// read commands, so it can be decoded just like data we read ourselves.
+	const auto error = _ioComponent.get().coalescedRead(_readParticipant, timeStamp, _coalescedCommands);
+
+	// Update the state
+	updateInputs(timeStamp, error);
+}
+
+auto TemplateIoTransaction::performRequestTask(const process::ExecutionContext &context) -> void
+{
+	request();
+}
+
+auto TemplateIoTransaction::request() -> void
+{
+	// Coalesced reads are performed by the I/O component when the data is collected
+	if (_coalesceReads)
+	{
+		return;
+	}
+
+	// Don't send anything if the replies to the last request have not been collected yet. Otherwise, the replies
+	// of the two requests would get mixed up.
+	if (_requestPending.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	const auto &handle = _ioComponent.get().handle();
+
+	// Send all the read commands, stopping at the first error
+	_requestError.clear();
+	_sentReadCount = 0;
+	for (auto &&operation : _readOperations)
+	{
+		if (const auto result = handle.sendRead(*operation._command); !result)
+		{
+			_requestError = result.error();
+			break;
+		}
+		++_sentReadCount;
+	}
+
+	// Hand the request over to the "collect" task
+	_requestPending.store(true, std::memory_order_release);
+}
+
+auto TemplateIoTransaction::performCollectTask(const process::ExecutionContext &context) -> void
+{
+	collect(context.scheduledTime());
+}
+
+auto TemplateIoTransaction::collect(std::chrono::system_clock::time_point timeStamp) -> void
+{
+	// Let the I/O component read the data if we coalesce our reads with other transactions
+	if (_coalesceReads)
 	{
-		/// @todo send the read command
-		ReadCommand::Payload payload = {};
+		readCoalesced(timeStamp);
+		return;
+	}
 
-		/// @todo if the read function does not throw errors, but uses return types or internal handle state,
-		// throw an std::system_error here on failure, or call updateInputs() directly.
+	// Leave the data as it is if nothing was requested
+	if (!_requestPending.load(std::memory_order_acquire))
+	{
+		return;
+	}
 
-		// The read was successful
-		updateInputs(timeStamp, payload);
+	// Receive the replies, unless sending failed. Stop at the first error.
+	const auto &handle = _ioComponent.get().handle();
+	auto error = _requestError;
+	std::size_t receivedCount = 0;
+	if (!error)
+	{
+		for (; receivedCount < _sentReadCount; ++receivedCount)
+		{
+			if (const auto result = handle.receiveRead(*_readOperations[receivedCount]._command); !result)
+			{
+				error = result.error();
+				// The failed read is no longer in flight
+				++receivedCount;
+				break;
+			}
+		}
 	}
-	catch (const std::exception &)
+
+	// Cancel the reads that are still in flight. Otherwise, their completions would be mistaken for the replies to
+	// the next request, and the kernel could still be writing into a receive buffer while it is being decoded.
+	for (auto index = receivedCount; index < _sentReadCount; ++index)
 	{
-		// Get the error from the current exception using this special utility function
-		const auto error = utils::eh::currentErrorCode();
-		// Update the state
-		updateInputs(timeStamp, utils::eh::unexpected(error));
+		handle.cancelRead(*_readOperations[index]._command);
 	}
+
+	// Allow the "request" task to send the next request
+	_requestPending.store(false, std::memory_order_release);
+
+	// Update the state
+	updateInputs(timeStamp, error);
 }
 
 auto TemplateIoTransaction::performWriteTask(const process::ExecutionContext &context) -> void
@@ -247,94 +577,274 @@ auto TemplateIoTransaction::performWriteTask(const process::ExecutionContext &co
 
 auto TemplateIoTransaction::write(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	// Protect use of the list of outputs to notify
-	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._outputsToNotify);
+	// Skip the cycle entirely if no output has a pending value
+	if (!_pendingOutputs.any())
+	{
+		return;
+	}
 
-	// Create a command
-	WriteCommand command;
+	// The "write" task and the writer thread may both write
+	std::scoped_lock lock(_writeMutex);
 
-	// Collect pending outputs
-	for (auto &&output : _outputs)
+	// Write rounds until no output is pending any more. Outputs that queue several values stay pending until all
+	// their values have been written.
+	for (std::size_t round = 0; round < _maxWriteRounds && _pendingOutputs.any(); ++round)
 	{
-		// Add the output
-		if (output.get().addToWriteCommand(command))
+		if (!writeRound(timeStamp))
 		{
-			_runtimeBuffers._outputsToNotify.push_back(output);
+			break;
 		}
 	}
+}
+
+auto TemplateIoTransaction::writeRound(std::chrono::system_clock::time_point timeStamp) -> bool
+{
+	// Protect use of the list of outputs to notify
+	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._outputsToNotify);
+
+	// Collect pending outputs. Only the outputs marked as pending are visited.
+	_pendingOutputs.collect([&](std::size_t outputIndex)
+		{
+			// Add the output
+			auto &output = _outputs[outputIndex];
+			if (output.get().addToWriteCommand(_writeCommandBuilder))
+			{
+				_runtimeBuffers._outputsToNotify.push_back(output);
+			}
+		});
 
 	// If there were no pending outputs, just bail
 	if (_runtimeBuffers._outputsToNotify.empty())
 	{
-		return;
+		return false;
+	}
+
+	// Send a command for each frame, stopping at the first error
+	const auto &handle = _ioComponent.get().handle();
+	std::error_code error;
+	for (auto &&frame : _writeCommandBuilder.build())
+	{
+		/// @todo initialize the write command with any additional information the I/O component needs.
+		const WriteCommand command(frame._address, _writeCommandBuilder.data(frame));
+		if (const auto result = handle.write(command); !result)
+		{
+			error = result.error();
+			break;
+		}
 	}
+	_writeCommandBuilder.finish(!error);
+
+	// Update the state
+	updateOutputs(timeStamp, error, _runtimeBuffers._outputsToNotify);
+
+	return !error;
+}
+
+auto TemplateIoTransaction::runWriter(std::stop_token stopToken) -> void
+{
+	/// @todo give the writer thread an appropriate real-time priority and CPU affinity
 
-	try
+	auto nextWrite = std::chrono::steady_clock::now();
+	while (!stopToken.stop_requested())
 	{
-		/// @todo send the command
+		// Wait for an output to be marked as pending
+		_writerWakeup.wait(false, std::memory_order_acquire);
+		if (stopToken.stop_requested())
+		{
+			break;
+		}
 
-		/// @todo if the write function does not throw errors, but uses return types or internal handle state,
-		// throw an std::system_error here on failure, or call updateOutputs() directly.
+		// Bound the bus load by spacing the writes. The pause ends early if we are asked to stop.
+		{
+			std::unique_lock lock(_writerPauseMutex);
+			_writerPause.wait_until(lock, stopToken, nextWrite, [] { return false; });
+		}
+		if (stopToken.stop_requested())
+		{
+			break;
+		}
 
-		// The write was successful
-		updateOutputs(timeStamp, std::error_code(), _runtimeBuffers._outputsToNotify);
+		// Reset the wakeup before writing, so that values scheduled during the write wake us up again
+		_writerWakeup.store(false, std::memory_order_release);
+
+		// Write the pending outputs
+		write(std::chrono::system_clock::now());
+		nextWrite = std::chrono::steady_clock::now() + _minWriteInterval;
+
+		// Outputs can still be pending if they have more queued values than fit into the write rounds of a single write,
+		// or if a write round failed before their remaining queued values were written. No one will wake us up for
+		// those, so write them after the next pause. The values of a failed write command itself are not retried: they
+		// have already been dequeued, and the failure is reported using the write state of the outputs.
+		if (_pendingOutputs.any())
+		{
+			_writerWakeup.store(true, std::memory_order_release);
+		}
 	}
-	catch (const std::exception &)
+}
+
+auto TemplateIoTransaction::payloadsUnchanged() const noexcept -> bool
+{
+	// The previous payloads are only meaningful if the inputs were decoded from them
+	if (!_inputsDecoded)
 	{
-		// Get the error from the current exception using this special utility function
-		const auto error = utils::eh::currentErrorCode();
-		// Update the state
-		updateOutputs(timeStamp, error, _runtimeBuffers._outputsToNotify);
+		return false;
 	}
+
+	// Compare the payloads byte by byte
+	return std::ranges::all_of(_readOperations, [](const auto &operation)
+		{ return std::ranges::equal(operation._command->payload().data(), operation._command->previousPayload().data()); });
 }
 
 auto TemplateIoTransaction::invalidateData(std::chrono::system_clock::time_point timeStamp) -> void
 {
-	// Set the state to "No Data"
-	updateInputs(timeStamp, utils::eh::unexpected(CustomError::NoData));
+	// If the data has already been invalidated, use the normal update, which leaves the inputs alone in that case
+	if (_inputError == CustomError::NoData)
+	{
+		updateInputs(timeStamp, CustomError::NoData);
+		return;
+	}
+
+	// Protect use of the pending event buffer
+	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._readEventsToRaise);
+
+	// Make a write sentinel
+	memory::WriteSentinel sentinel { _readDataBlock };
+
+	// Set the common read state to "No Data". This always counts as a change, because the error is different from before.
+	_readState.update(sentinel, timeStamp, CustomError::NoData, _runtimeBuffers._readEventsToRaise);
+	_readDiagnostics.update(sentinel);
+
+	// Reset all the inputs
+	for (auto &&operation : _readOperations)
+	{
+		operation._decodeTable.invalidate(sentinel, timeStamp, _raiseInputEvents, _runtimeBuffers._readEventsToRaise);
+	}
+
+	// All inputs changed
+	_changedInputs.reset();
+	_changedInputs.markAll();
+	_changedInputs.update(sentinel, _runtimeBuffers._readEventsToRaise);
+
+	// The inputs no longer hold decoded data
+	_inputsDecoded = false;
+	_inputError = CustomError::NoData;
+
+	// Publish the new version of the inputs before the events are raised, so that event handlers can read it
+	publishInputSnapshot(timeStamp, CustomError::NoData);
+
+	// Commit the data and raise the events
+	sentinel.commit(timeStamp, _runtimeBuffers._readEventsToRaise);
 }
 
-auto TemplateIoTransaction::updateInputs(std::chrono::system_clock::time_point timeStamp, const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError)
-	-> void
+auto TemplateIoTransaction::updateInputs(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void
 {
+	// If the payloads are identical to the previous ones, none of the inputs can have changed. The same is true if we
+	// already have the same error, because the inputs already hold the values used for errors.
+	const auto payloadUnchanged = !error && payloadsUnchanged();
+	const auto unchanged = payloadUnchanged || (error && error == _inputError);
+
+	// Decode all the inputs before opening the data block for writing, so that the data block is held for as short a time as possible
+	if (!unchanged)
+	{
+		for (auto &&operation : _readOperations)
+		{
+			// Each input gets the payload of its own read command, or the error
+			using PayloadOrError = utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>;
+			const auto payloadOrError = error ? PayloadOrError(utils::eh::unexpected(error)) : PayloadOrError(std::cref(operation._command->payload()));
+
+			operation._decodeTable.decode(payloadOrError);
+		}
+	}
+
 	// Protect use of the pending event buffer
-	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._eventsToRaise);
+	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._readEventsToRaise);
 
 	// Make a write sentinel
 	memory::WriteSentinel sentinel { _readDataBlock };
 
 	// Update the common read state
-	const auto commonChanges = _readState.update(sentinel, timeStamp, payloadOrError.error(), _runtimeBuffers._eventsToRaise);
+	const auto commonChanges = _readState.update(sentinel, timeStamp, error, _runtimeBuffers._readEventsToRaise);
+	// Update the diagnostics
+	_readDiagnostics.countRead(payloadUnchanged);
+	_readDiagnostics.update(sentinel);
 
-	// Update all the inputs
-	for (auto &&input : _inputs)
+	// Start collecting the inputs that change
+	const auto changedInputs = _changedInputs.reset();
+
+	// Update all the inputs, one read command at a time
+	for (auto &&operation : _readOperations)
 	{
-		input.get().updateReadState(sentinel, timeStamp, payloadOrError, commonChanges, _runtimeBuffers._eventsToRaise);
+		// Just keep the inputs if nothing changed
+		if (unchanged)
+		{
+			operation._decodeTable.keep(sentinel);
+			continue;
+		}
+
+		// Write the decoded values
+		operation._decodeTable.update(
+			sentinel, timeStamp, commonChanges, changedInputs, _raiseInputEvents, _runtimeBuffers._readEventsToRaise);
 	}
 
+	// Publish the inputs that changed
+	_changedInputs.update(sentinel, _runtimeBuffers._readEventsToRaise);
+
+	// The next payloads can only be compared to these ones if the inputs were decoded from them
+	_inputsDecoded = !error;
+	_inputError = error;
+
+	// Publish the new version of the inputs before the events are raised, so that event handlers can read it
+	publishInputSnapshot(timeStamp, error);
+
 	// Commit the data and raise the events
-	sentinel.commit(timeStamp, _runtimeBuffers._eventsToRaise);
+	sentinel.commit(timeStamp, _runtimeBuffers._readEventsToRaise);
+}
+
+auto TemplateIoTransaction::publishInputSnapshot(std::chrono::system_clock::time_point timeStamp, std::error_code error) noexcept -> void
+{
+	if (_readVersionCount == 0)
+	{
+		return;
+	}
+
+	// Get a free version. If readers still pin all the other versions, they keep seeing the current one until the next update.
+	const auto data = _inputSnapshots.beginWrite();
+	if (data.empty())
+	{
+		return;
+	}
+
+	// Write the header and the values. The values are taken from the decode tables, which hold the same values as the data block.
+	InputSnapshot::writeHeader(data, timeStamp, error);
+	const auto cells = InputSnapshot::cells(data);
+	for (auto &&operation : _readOperations)
+	{
+		operation._decodeTable.storeValues(cells);
+	}
+
+	_inputSnapshots.publish();
 }
 
 auto TemplateIoTransaction::updateOutputs(std::chrono::system_clock::time_point timeStamp, std::error_code error, const OutputList &outputs) -> void
 {
 	// Protect use of the pending event buffer
-	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._eventsToRaise);
+	RuntimeBufferSentinel eventsToRaiseSentinel(_runtimeBuffers._writeEventsToRaise);
 
-	// Make a write sentinel
-	memory::WriteSentinel sentinel { _readDataBlock };
+	// Make a write sentinel. The write states are attached to the write data block, so that write completions do not
+	// contend with readers of the input data.
+	memory::WriteSentinel sentinel { _writeDataBlock };
 
 	// Update the latest state
-	_writeState.update(sentinel, timeStamp, error, _runtimeBuffers._eventsToRaise);
+	_writeState.update(sentinel, timeStamp, error, _runtimeBuffers._writeEventsToRaise);
 
 	// Update all the relevant outputs
 	for (auto &&output : outputs)
 	{
-		output.get().updateWriteState(sentinel, timeStamp, error, _runtimeBuffers._eventsToRaise);
+		output.get().updateWriteState(sentinel, timeStamp, error, _runtimeBuffers._writeEventsToRaise);
 	}
 
 	// Commit the data and raise the events
-	sentinel.commit(timeStamp, _runtimeBuffers._eventsToRaise);
+	sentinel.commit(timeStamp, _runtimeBuffers._writeEventsToRaise);
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
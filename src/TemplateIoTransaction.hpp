@@ -2,12 +2,23 @@
 #pragma once
 
 #include "Attributes.hpp"
+#include "ChangedInputSet.hpp"
 #include "CommonReadState.hpp"
+#include "WriteCommandBuilder.hpp"
 #include "WriteState.hpp"
 #include "CustomError.hpp"
+#include "DataLayout.hpp"
+#include "DecodeTable.hpp"
+#include "DirtyBitmap.hpp"
+#include "InputSnapshot.hpp"
 #include "Types.hpp"
 #include "ReadCommand.hpp"
+#include "ReadDiagnostics.hpp"
+#include "ReadPlanner.hpp"
+#include "VersionedBuffer.hpp"
+#include "CollectTask.hpp"
 #include "ReadTask.hpp"
+#include "RequestTask.hpp"
 #include "WriteTask.hpp"
 
 #include <xentara/memory/Array.hpp>
@@ -19,8 +30,15 @@
 #include <xentara/utils/eh/expected.hpp>
 
 #include <string_view>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
 #include <vector>
 
 namespace xentara::plugins::templateDriver
@@ -79,9 +97,49 @@ public:
 	{
 		return _readDataBlock;
 	}
+
+	/// @brief Gets a consistent copy of the values of all the inputs
+	///
+	/// This function is wait-free, and may be called from any thread. It never blocks the I/O transaction from updating
+	/// the inputs, and is never blocked by it.
+	/// @return The snapshot, or std::nullopt if the I/O transaction does not keep versions of its inputs.
+	auto readInputSnapshot() const noexcept -> std::optional<InputSnapshot>
+	{
+		if (_readVersionCount == 0)
+		{
+			return std::nullopt;
+		}
+		return InputSnapshot(_inputSnapshots.read());
+	}
 	
 	/// @brief This function adds an output to be processed by the I/O transaction
-	auto addOutput(std::reference_wrapper<AbstractOutput> output) -> void;
+	/// @return The index of the output, which must be passed to markOutputPending()
+	auto addOutput(std::reference_wrapper<AbstractOutput> output) -> std::size_t;
+
+	/// @brief Marks an output as having a pending value
+	///
+	/// This function is lock-free, and may be called from any thread. The output value must be enqueued
+	/// before calling this function.
+	/// @param outputIndex The index returned by addOutput()
+	auto markOutputPending(std::size_t outputIndex) noexcept -> void
+	{
+		_pendingOutputs.mark(outputIndex);
+
+		// Wake up the writer thread, unless it has already been woken up
+		if (_wakeOnWrite && !_writerWakeup.load(std::memory_order_relaxed) && !_writerWakeup.exchange(true, std::memory_order_acq_rel))
+		{
+			_writerWakeup.notify_one();
+		}
+	}
+
+	/// @brief Marks an output as still pending while its pending values are being written
+	///
+	/// This is called by outputs that queue several values, so that their remaining values are written by subsequent
+	/// commands of the same write cycle. Unlike markOutputPending(), this does not wake up the writer thread.
+	auto keepOutputPending(std::size_t outputIndex) noexcept -> void
+	{
+		_pendingOutputs.mark(outputIndex);
+	}
 
 	/// @brief Gets the data block that holds the data for the write operations
 	constexpr auto writeDataBlock() noexcept -> DataBlock &
@@ -116,6 +174,8 @@ private:
 	// The tasks need access to out private member functions
 	friend class ReadTask<TemplateIoTransaction>;
 	friend class WriteTask<TemplateIoTransaction>;
+	friend class RequestTask<TemplateIoTransaction>;
+	friend class CollectTask<TemplateIoTransaction>;
 
 	/// @brief This function is called by the "read" task.
 	///
@@ -129,17 +189,60 @@ private:
 	/// This function attempts to write the value if the I/O component is up.
 	auto performWriteTask(const process::ExecutionContext &context) -> void;
 	/// @brief Attempts to write any pending value to the I/O component and updates the state accordingly.
+	///
+	/// Outputs that queue several values remain pending after their first value was written. Their remaining values
+	/// are written in additional rounds, up to _maxWriteRounds rounds per call.
 	auto write(std::chrono::system_clock::time_point timeStamp) -> void;	
+	/// @brief Writes a single value of each pending output, and updates the state accordingly.
+	/// @return true if values were written successfully, or false if there was nothing to write or an error occurred.
+	auto writeRound(std::chrono::system_clock::time_point timeStamp) -> bool;
+
+	/// @brief Gets the data from the combined read commands of the I/O component and updates the state accordingly.
+	auto readCoalesced(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief This function is called by the "request" task.
+	///
+	/// This function sends the read commands without waiting for the replies.
+	auto performRequestTask(const process::ExecutionContext &context) -> void;
+	/// @brief Sends the read commands to the I/O component, unless a previous request has not been collected yet.
+	auto request() -> void;
+
+	/// @brief This function is called by the "collect" task.
+	///
+	/// This function receives the replies to the read commands sent by the "request" task.
+	auto performCollectTask(const process::ExecutionContext &context) -> void;
+	/// @brief Receives the replies to the last request, if any, and updates the state accordingly.
+	auto collect(std::chrono::system_clock::time_point timeStamp) -> void;
+
+	/// @brief The function executed by the writer thread used in wake-on-write mode
+	///
+	/// The thread waits until an output is marked as pending, and then writes the pending outputs right away, without
+	/// waiting for the next "write" task. Consecutive writes are spaced at least _minWriteInterval apart.
+	auto runWriter(std::stop_token stopToken) -> void;
+
+	/// @brief Checks whether the payloads of all read commands are identical to the payloads the inputs were last decoded from
+	auto payloadsUnchanged() const noexcept -> bool;
 
 	/// @brief Invalidates any read data
+	///
+	/// Unlike a read error, this resets all the inputs in a single sweep, without decoding or comparing anything.
 	auto invalidateData(std::chrono::system_clock::time_point timeStamp) -> void;
 
-	/// @brief Updates the inputs with valid data and sends events
+	/// @brief Publishes a new version of the inputs for readInputSnapshot(), if the I/O transaction keeps versions
+	///
+	/// This must be called after the inputs have been updated.
+	/// @param timeStamp The update time stamp
+	/// @param error The read error, or a default constructed std::error_code object if the data was read successfully.
+	auto publishInputSnapshot(std::chrono::system_clock::time_point timeStamp, std::error_code error) noexcept -> void;
+
+	/// @brief Updates the inputs and sends events
+	///
+	/// If no error occurred, each input is decoded from the payload of the read command it belongs to. If the payloads
+	/// are identical to the previous ones, or if the same error occurred as last time, the inputs are kept as they are, and only
+	/// the common read state is updated.
 	/// @param timeStamp The update time stamp
-	/// @param payloadOrError This is a variant-like type that will hold either the payload of the read command, or an std::error_code object
-	/// containing a read error.
-	auto updateInputs(std::chrono::system_clock::time_point timeStamp,
-		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError) -> void;
+	/// @param error The read error, or a default constructed std::error_code object if all read commands were successful.
+	auto updateInputs(std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void;
 
 	/// @brief Updates the outputs and sends events
 	/// @param timeStamp The update time stamp
@@ -157,31 +260,95 @@ private:
 
 	auto prepare() -> void final;
 
+	auto cleanup() -> void final;
+
 	/// @}
 
 	/// @brief The I/O component this transaction belongs to
 	/// @todo give this a more descriptive name, e.g. "_device"
 	std::reference_wrapper<TemplateIoComponent> _ioComponent;
 
-	/// @class xentara::plugins::templateDriver::TemplateIoTransaction
-	/// @todo Split read and write command split into several commands each, if necessary.
-	/// 
-	/// @todo Some Some I/O components may need to have the read and write command split into several commands each.
-	/// Some I/O components may require a separate command for each data type, for example, or may only be able to
-	/// read or write objects with continuous addresses. if this is the case, each separate command needs its own list
-	/// of inputs and/or output, as well as its own read state and write state.
-
-	/// @brief The list of inputs
+	/// @brief A read command together with the information needed to decode its payload
+	struct ReadOperation
+	{
+		/// @brief The read command to send
+		std::unique_ptr<ReadCommand> _command;
+		/// @brief The descriptors for the inputs that are read using the command
+		DecodeTable _decodeTable;
+	};
+
+	/// @brief The list of inputs. The inputs are sorted by address when the transaction is realized.
 	std::vector<std::reference_wrapper<AbstractInput>> _inputs;
+	/// @brief The number of each input in _inputs, which is its position in the order the inputs were added.
+	///
+	/// The inputs are identified by these numbers in the bitmap of changed inputs, so that the bits follow the order of
+	/// the configuration rather than the order of the addresses.
+	std::vector<std::size_t> _inputNumbers;
 	/// @brief The list of outputs
 	std::vector<std::reference_wrapper<AbstractOutput>> _outputs;
 
-	/// @brief The read command to send, or nullptr if it hasn't been constructed yet.
-	std::unique_ptr<ReadCommand> _readCommand;
+	/// @brief The planner used to split the inputs into several read commands
+	ReadPlanner _readPlanner;
+	/// @brief The address ranges to read, as determined by the read planner
+	std::vector<ReadPlanner::Range> _readPlan;
+
+	/// @brief The read operations to perform. This is empty if the commands haven't been constructed yet.
+	std::vector<ReadOperation> _readOperations;
+
+	/// @brief Whether the inputs are read using the combined read commands of the I/O component
+	bool _coalesceReads { false };
+	/// @brief The index that identifies this transaction in the combined read commands of the I/O component
+	std::size_t _readParticipant { 0 };
+	/// @brief The commands of the read operations, which receive the data copied from the combined read commands
+	std::vector<ReadCommand *> _coalescedCommands;
+
+	/// @brief Whether the inputs hold the values decoded from the previous payloads of the read commands
+	bool _inputsDecoded { false };
+	/// @brief The error the inputs were last updated with, or a default constructed std::error_code object if they were decoded.
+	///
+	/// The inputs start out without data, so this is initialized with CustomError::NoData.
+	std::error_code _inputError { CustomError::NoData };
+
+	/// @brief The error that occurred sending the last request, or a default constructed std::error_code object
+	/// if all read commands were sent successfully.
+	std::error_code _requestError;
+	/// @brief The number of read commands the last request sent successfully. The reads of these commands are in flight
+	/// until the "collect" task either receives or cancels them.
+	std::size_t _sentReadCount { 0 };
+	/// @brief Whether the "request" task has sent read commands whose replies have not been collected yet.
+	///
+	/// This also publishes _requestError and _sentReadCount to the "collect" task, which may run on a different thread.
+	std::atomic<bool> _requestPending { false };
+
+	/// @brief The outputs that have pending values, indexed like _outputs
+	DirtyBitmap _pendingOutputs;
+
+	/// @brief Whether pending outputs are written by a writer thread as soon as they are scheduled
+	bool _wakeOnWrite { false };
+	/// @brief The minimum interval between two writes performed by the writer thread
+	std::chrono::nanoseconds _minWriteInterval { 0 };
+	/// @brief Set when an output is marked as pending, to wake up the writer thread
+	std::atomic<bool> _writerWakeup { false };
+	/// @brief Used by the writer thread to wait between writes. The wait is interrupted when the thread is asked to stop.
+	std::condition_variable_any _writerPause;
+	/// @brief The mutex used with _writerPause
+	std::mutex _writerPauseMutex;
+	/// @brief The writer thread used in wake-on-write mode
+	std::jthread _writerThread;
+	/// @brief Serializes writes performed by the "write" task and the writer thread
+	std::mutex _writeMutex;
+
+	/// @brief The default maximum number of write rounds per write cycle
+	static constexpr std::size_t kDefaultMaxWriteRounds = 16;
+	/// @brief The maximum number of rounds a single write cycle may use to write the values queued for the outputs
+	std::size_t _maxWriteRounds { kDefaultMaxWriteRounds };
+
+	/// @brief The builder used to merge the pending outputs into as few write commands as possible
+	WriteCommandBuilder _writeCommandBuilder;
 
 	/// @class xentara::plugins::templateDriver::TemplateIoTransaction
-	/// @note There is no member for the write command, as the write command is constructed on-the-fly,
-	/// depending on which outputs wave to be written.
+	/// @note There is no member for the write commands, as the write commands are constructed on-the-fly,
+	/// depending on which outputs have to be written.
 
 	/// @brief The array that describes the structure of the read data block
 	memory::Array _readDataArray;
@@ -195,6 +362,18 @@ private:
 
 	/// @brief The common read state for all inputs
 	CommonReadState _readState;
+	/// @brief Diagnostic information about the read commands
+	ReadDiagnostics _readDiagnostics;
+	/// @brief The inputs that changed during the last update
+	ChangedInputSet _changedInputs;
+	/// @brief How the states of the inputs are arranged in the read data block
+	DataLayout _dataLayout { DataLayout::Interleaved };
+	/// @brief Whether the inputs raise their own changed events, in addition to the event of _changedInputs
+	bool _raiseInputEvents { true };
+	/// @brief The number of versions of the inputs kept for readInputSnapshot(), or 0 if no versions are kept
+	std::size_t _readVersionCount { 0 };
+	/// @brief The versions of the inputs, if _readVersionCount is not 0
+	VersionedBuffer _inputSnapshots;
 	/// @brief The state for the last write command 
 	WriteState _writeState;
 
@@ -202,16 +381,24 @@ private:
 	ReadTask<TemplateIoTransaction> _readTask { *this };
 	/// @brief The "write" task
 	WriteTask<TemplateIoTransaction> _writeTask { *this };
+	/// @brief The "request" task
+	RequestTask<TemplateIoTransaction> _requestTask { *this };
+	/// @brief The "collect" task
+	CollectTask<TemplateIoTransaction> _collectTask { *this };
 
 	/// @brief Preallocated runtime buffers
 	///
 	/// This structure contains preallocated buffers for data needed when sending commands.
 	/// the buffers are preallocated to avoid memory allocations in the read() and write() functions,
 	/// which would not be real-time safe.
+	///
+	/// Reads and writes use separate buffers, so that they can run on different threads.
 	struct
 	{
-		/// @brief The list of events to raise after a read or write
-		PendingEventList _eventsToRaise;
+		/// @brief The list of events to raise after a read
+		PendingEventList _readEventsToRaise;
+		/// @brief The list of events to raise after a write
+		PendingEventList _writeEventsToRaise;
 
 		/// @brief The outputs to notify after a write operation
 		OutputList _outputsToNotify;
@@ -2,7 +2,9 @@
 #include "TemplateOutput.hpp"
 
 #include "Attributes.hpp"
+#include "DecodeTable.hpp"
 #include "TemplateIoTransaction.hpp"
+#include "WriteCommandBuilder.hpp"
 
 #include <xentara/config/Context.hpp>
 #include <xentara/config/Errors.hpp>
@@ -16,17 +18,29 @@
 #include <xentara/utils/json/decoder/Object.hpp>
 #include <xentara/utils/json/decoder/Errors.hpp>
 
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <variant>
+
 namespace xentara::plugins::templateDriver
 {
 	
 using namespace std::literals;
 
-const model::Attribute TemplateOutput::kValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadWrite, data::DataType::kFloatingPoint };
+const model::Attribute TemplateOutput::kBooleanValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadWrite, data::DataType::kBoolean };
+
+const model::Attribute TemplateOutput::kIntegerValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadWrite, data::DataType::kInteger };
+
+const model::Attribute TemplateOutput::kFloatingPointValueAttribute { model::Attribute::kValue, model::Attribute::Access::ReadWrite, data::DataType::kFloatingPoint };
 
 auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Context &context) -> void
 {
 	// Go through all the members of the JSON object that represents this object
 	bool ioTransactionLoaded = false;
+	bool addressLoaded = false;
+	std::size_t queueCapacity = FifoQueue<double>::kDefaultCapacity;
+	QueueOverflowPolicy overflowPolicy = QueueOverflowPolicy::DropNewest;
 	for (auto && [name, value] : jsonObject)
     {
 		/// @todo use a more descriptive keyword, e.g. "poll"
@@ -36,10 +50,84 @@ auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Cont
 				{ 
 					_ioTransaction = &ioTransaction.get();
 					ioTransaction.get().addInput(*this);
-					ioTransaction.get().addOutput(*this);
+					_outputIndex = ioTransaction.get().addOutput(*this);
 				});
 			ioTransactionLoaded = true;
 		}
+		/// @todo use a keyword that matches the device's terminology, e.g. "register"
+		else if (name == "address"sv)
+		{
+			_address = value.asNumber<std::uint64_t>();
+			addressLoaded = true;
+		}
+		else if (name == "dataType"sv)
+		{
+			const auto valueType = parseValueType(value.asString<std::string>());
+			if (!valueType)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown data type in template output"));
+			}
+			_valueType = *valueType;
+		}
+		else if (name == "encoding"sv)
+		{
+			const auto encoding = parseEncoding(value.asString<std::string>());
+			if (!encoding)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown encoding in template output"));
+			}
+			_encoding = *encoding;
+		}
+		else if (name == "scale"sv)
+		{
+			_scaling._factor = value.asNumber<double>();
+			// A scale of 0 cannot be reversed when writing, and would map every raw value to the offset when reading
+			if (!std::isfinite(_scaling._factor) || _scaling._factor == 0.0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the scale of a template output must be finite and not 0"));
+			}
+		}
+		else if (name == "offset"sv)
+		{
+			_scaling._offset = value.asNumber<double>();
+			if (!std::isfinite(_scaling._offset))
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the offset of a template output must be finite"));
+			}
+		}
+		else if (name == "queue"sv)
+		{
+			const auto queue = value.asString<std::string>();
+			if (queue == "single"sv)
+			{
+				_useFifo = false;
+			}
+			else if (queue == "fifo"sv)
+			{
+				_useFifo = true;
+			}
+			else
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown queue type in template output"));
+			}
+		}
+		else if (name == "queueCapacity"sv)
+		{
+			queueCapacity = value.asNumber<std::size_t>();
+			if (queueCapacity == 0)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("the queue capacity of a template output must not be zero"));
+			}
+		}
+		else if (name == "overflowPolicy"sv)
+		{
+			const auto policy = parseQueueOverflowPolicy(value.asString<std::string>());
+			if (!policy)
+			{
+				utils::json::decoder::throwWithLocation(value, std::runtime_error("unknown overflow policy in template output"));
+			}
+			overflowPolicy = *policy;
+		}
 		/// @todo load custom configuration parameters
 		else if (name == "TODO"sv)
 		{
@@ -67,17 +155,60 @@ auto TemplateOutput::load(utils::json::decoder::Object &jsonObject, config::Cont
 		/// @todo replace "I/O transaction" and "template output" with more descriptive names
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing I/O transaction in template output"));
 	}
+	// Make sure that an address was specified
+	if (!addressLoaded)
+	{
+		/// @todo replace "template output" with a more descriptive name
+		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("missing address in template output"));
+	}
 	/// @todo perform consistency and completeness checks
 	if (!"TODO")
 	{
 		/// @todo use an error message that tells the user exactly what is wrong
 		utils::json::decoder::throwWithLocation(jsonObject, std::runtime_error("TODO is wrong with template output"));
 	}
+
+	// Create the state for the correct value type
+	emplaceValueType(_typedState, _valueType);
+
+	// Allocate the slots of the pending value queue, if the value type needs them. Strings are copied into preallocated
+	// slots, so that scheduling a value does not allocate memory. No value type uses strings yet, so the slots always
+	// have the default size.
+	std::visit([]<typename DataType>(TypedState<DataType> &state)
+		{
+			if constexpr (requires { state._pendingOutputValue.reserve(std::size_t()); })
+			{
+				state._pendingOutputValue.reserve(SingleValueQueue<std::string>::kDefaultMaxLength);
+			}
+		},
+		_typedState);
+
+	// Create the FIFO queue, if requested
+	if (_useFifo)
+	{
+		std::visit([&]<typename DataType>(TypedState<DataType> &state)
+			{ state._pendingOutputFifo = std::make_unique<FifoQueue<DataType>>(queueCapacity, overflowPolicy); },
+			_typedState);
+	}
+}
+
+auto TemplateOutput::valueAttribute() const noexcept -> const model::Attribute &
+{
+	switch (_valueType)
+	{
+	case ValueType::Boolean:
+		return kBooleanValueAttribute;
+	case ValueType::Float:
+	case ValueType::Double:
+		return kFloatingPointValueAttribute;
+	default:
+		return kIntegerValueAttribute;
+	}
 }
 
 auto TemplateOutput::dataType() const -> const data::DataType &
 {
-	return kValueAttribute.dataType();
+	return valueAttribute().dataType();
 }
 
 auto TemplateOutput::directions() const -> io::Directions
@@ -96,15 +227,18 @@ auto TemplateOutput::forEachAttribute(const model::ForEachAttributeFunction &fun
 
 	return
 		// Handle all the attributes we support directly
-		function(kValueAttribute) ||
+		function(valueAttribute()) ||
 
 		// Handle the read state attributes
-		_readState.forEachAttribute(function) ||
+		std::visit([&](const auto &state) { return state._readState.forEachAttribute(function); }, _typedState) ||
 		// Also handle the common read state attributes from the I/O transaction
 		_ioTransaction->forEachReadStateAttribute(function) ||
 
 		// Handle the write state attributes
-		_writeState.forEachAttribute(function);
+		_writeState.forEachAttribute(function) ||
+
+		// Handle the queue diagnostics, if we have a FIFO queue
+		(_useFifo && _queueDiagnostics.forEachAttribute(function));
 
 	/// @todo handle any additional attributes this class supports, including attributes inherited from the I/O component and the I/O transaction
 }
@@ -120,7 +254,7 @@ auto TemplateOutput::forEachEvent(const model::ForEachEventFunction &function) -
 
 	return
 		// Handle the read state events
-		_readState.forEachEvent(function, sharedFromThis()) ||
+		std::visit([&](auto &state) { return state._readState.forEachEvent(function, sharedFromThis()); }, _typedState) ||
 		// Also handle the common read state events from the I/O transaction
 		_ioTransaction->forEachReadStateEvent(function) ||
 
@@ -144,13 +278,13 @@ auto TemplateOutput::makeReadHandle(const model::Attribute &attribute) const noe
 	const auto &writeDataBlock = _ioTransaction->writeDataBlock();
 	
 	// Handle the value attribute separately
-	if (attribute == kValueAttribute)
+	if (attribute == valueAttribute())
 	{
-		return _readState.valueReadHandle(readDataBlock);
+		return std::visit([&](const auto &state) { return state._readState.valueReadHandle(readDataBlock); }, _typedState);
 	}
 	
 	// Handle the read state attributes
-	if (auto handle = _readState.makeReadHandle(readDataBlock, attribute))
+	if (auto handle = std::visit([&](const auto &state) { return state._readState.makeReadHandle(readDataBlock, attribute); }, _typedState))
 	{
 		return handle;
 	}
@@ -166,6 +300,15 @@ auto TemplateOutput::makeReadHandle(const model::Attribute &attribute) const noe
 		return handle;
 	}
 
+	// Handle the queue diagnostics, if we have a FIFO queue
+	if (_useFifo)
+	{
+		if (auto handle = _queueDiagnostics.makeReadHandle(writeDataBlock, attribute))
+		{
+			return handle;
+		}
+	}
+
 	/// @todo handle any additional readable attributes this class supports, including attributes inherited from the I/O component and the I/O transaction
 
 	return std::nullopt;
@@ -174,11 +317,12 @@ auto TemplateOutput::makeReadHandle(const model::Attribute &attribute) const noe
 auto TemplateOutput::makeWriteHandle(const model::Attribute &attribute) noexcept -> std::optional<data::WriteHandle>
 {
 	// Handle the value attribute
-	if (attribute == kValueAttribute)
+	if (attribute == valueAttribute())
 	{
-		// This magic code creates a write handle of type double that calls scheduleWrite() on this.
-		/// @todo use the correct value type
-		return data::WriteHandle { std::in_place_type<double>, &TemplateOutput::scheduleOutputValue, weakFromThis() };
+		// This magic code creates a write handle of the correct type that calls scheduleOutputValue() on this.
+		return std::visit([this]<typename DataType>(const TypedState<DataType> &)
+			{ return data::WriteHandle { std::in_place_type<DataType>, &TemplateOutput::scheduleOutputValue<DataType>, weakFromThis() }; },
+			_typedState);
 	}
 
 	/// @todo handle any additional writable attributes this class supports, including attributes inherited from the I/O component and the I/O transaction
@@ -186,52 +330,72 @@ auto TemplateOutput::makeWriteHandle(const model::Attribute &attribute) noexcept
 	return std::nullopt;
 }
 
-auto TemplateOutput::attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void
+auto TemplateOutput::attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void
 {
-	_readState.attach(dataArray, eventCount);
+	std::visit([&](auto &state) { state._readState.attach(dataArray, eventCount, pass); }, _typedState);
 }
 
-auto TemplateOutput::updateReadState(WriteSentinel &writeSentinel,
-	std::chrono::system_clock::time_point timeStamp,
-	const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
-	const CommonReadState::Changes &commonChanges,
-	PendingEventList &eventsToRaise) -> void
+auto TemplateOutput::addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void
 {
-	// Check if we have a valid payload
-	if (payloadOrError)
-	{
-		/// @todo decode the value from the payload data
-		double value = {};
+	std::visit([&]<typename DataType>(TypedState<DataType> &state)
+		{ decodeTable.add<DataType>(state._readState.descriptor(payloadOffset), _encoding, _scaling); },
+		_typedState);
+}
+
+template <typename DataType>
+auto TemplateOutput::scheduleOutputValue(DataType value) noexcept -> void
+{
+	// The write handle was created for the value type, so the state must have the same type
+	auto &state = std::get<TypedState<DataType>>(_typedState);
 
-		// Update the read state
-		_readState.update(writeSentinel, timeStamp, value, commonChanges, eventsToRaise);
+	// Enqueue the value first, so that it is visible to the I/O transaction once the output is marked as pending.
+	// If the FIFO queue overflows, the overflow is counted by the queue itself.
+	if (state._pendingOutputFifo)
+	{
+		state._pendingOutputFifo->enqueue(value);
 	}
-	// We have an error
 	else
 	{
-		// Update the read state with the error
-		_readState.update(writeSentinel, timeStamp, utils::eh::unexpected(payloadOrError.error()), commonChanges, eventsToRaise);
+		state._pendingOutputValue.enqueue(value);
 	}
+	_ioTransaction->markOutputPending(_outputIndex);
 }
 
-auto TemplateOutput::addToWriteCommand(WriteCommand &command) -> bool
+auto TemplateOutput::addToWriteCommand(WriteCommandBuilder &builder) -> bool
 {
-	// Get the value
-	auto pendingValue = _pendingOutputValue.dequeue();
-	// If there was no pending value, do nothing
-	if (!pendingValue)
-	{
-		return false;
-	}
+	return std::visit([&](auto &state)
+		{
+			// Get the value
+			auto pendingValue = state._pendingOutputFifo ? state._pendingOutputFifo->dequeue() : state._pendingOutputValue.dequeue();
+			// If there was no pending value, do nothing
+			if (!pendingValue)
+			{
+				return false;
+			}
+
+			// If there are more values in the FIFO queue, stay pending, so that they are written by subsequent commands
+			if (state._pendingOutputFifo && !state._pendingOutputFifo->empty())
+			{
+				_ioTransaction->keepOutputPending(_outputIndex);
+			}
 
-	/// @todo add the value to the command
+			// Encode the value directly into the command data. The builder numbers the outputs the same way the transaction does.
+			const auto data = builder.stage(_outputIndex);
+			assert(data.size() == dataSize());
+			encodeValue(_encoding, *pendingValue, _scaling, data.data());
 
-	return true;
+			return true;
+		},
+		_typedState);
 }
 
 auto TemplateOutput::attachOutput(memory::Array &dataArray, std::size_t &eventCount) -> void
 {
 	_writeState.attach(dataArray, eventCount);
+	if (_useFifo)
+	{
+		_queueDiagnostics.attach(dataArray);
+	}
 }
 
 auto TemplateOutput::updateWriteState(WriteSentinel &writeSentinel,
@@ -241,6 +405,12 @@ auto TemplateOutput::updateWriteState(WriteSentinel &writeSentinel,
 {
 	// Update the write state
 	_writeState.update(writeSentinel, timeStamp, error, eventsToRaise);
+	// Update the queue diagnostics
+	if (_useFifo)
+	{
+		const auto overflowCount = std::visit([](const auto &state) { return state._pendingOutputFifo->overflowCount(); }, _typedState);
+		_queueDiagnostics.update(writeSentinel, overflowCount);
+	}
 }
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
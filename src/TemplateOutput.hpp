@@ -3,14 +3,21 @@
 
 #include "AbstractInput.hpp"
 #include "AbstractOutput.hpp"
+#include "FifoQueue.hpp"
 #include "PerValueReadState.hpp"
+#include "QueueDiagnostics.hpp"
+#include "ValueCodec.hpp"
+#include "ValueType.hpp"
 #include "WriteState.hpp"
 #include "SingleValueQueue.hpp"
 
 #include <xentara/skill/DataPoint.hpp>
 #include <xentara/skill/EnableSharedFromThis.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string_view>
 
 namespace xentara::plugins::templateDriver
@@ -62,28 +69,39 @@ public:
 	
 	/// @}
 
-	/// @name Virtual Overrides for AbstractInput
+	/// @name Virtual Overrides for AbstractInput and AbstractOutput
 	/// @{
 
 	auto ioComponent() const -> const TemplateIoComponent & final
 	{
 		return _ioComponent;
 	}
+
+	auto address() const noexcept -> std::uint64_t final
+	{
+		return _address;
+	}
+
+	auto dataSize() const noexcept -> std::size_t final
+	{
+		return encodedSize(_encoding, valueSize(_valueType));
+	}
 	
-	auto attachInput(memory::Array &dataArray, std::size_t &eventCount) -> void final;
+	/// @}
 
-	auto updateReadState(WriteSentinel &writeSentinel,
-		std::chrono::system_clock::time_point timeStamp,
-		const utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code> &payloadOrError,
-		const CommonReadState::Changes &commonChanges,
-		PendingEventList &eventsToRaise) -> void final;
+	/// @name Virtual Overrides for AbstractInput
+	/// @{
+
+	auto attachInput(memory::Array &dataArray, std::size_t &eventCount, AttachPass pass) -> void final;
+
+	auto addToDecodeTable(DecodeTable &decodeTable, std::size_t payloadOffset) -> void final;
 	
 	/// @}
 
 	/// @name Virtual Overrides for AbstractOutput
 	/// @{
 
-	auto addToWriteCommand(WriteCommand &command) -> bool final;
+	auto addToWriteCommand(WriteCommandBuilder &builder) -> bool final;
 
 	auto attachOutput(memory::Array &dataArray, std::size_t &eventCount) -> void final;
 
@@ -95,20 +113,37 @@ public:
 	
 	/// @}
 
-	/// @brief A Xentara attribute containing the current value.
+	/// @brief A Xentara attribute containing the current value of a boolean output.
 	/// @note This is a member of this class rather than of the attributes namespace, because the access flags
 	/// and type may differ from class to class
-	static const model::Attribute kValueAttribute;
+	static const model::Attribute kBooleanValueAttribute;
+	/// @brief A Xentara attribute containing the current value of an integer output.
+	static const model::Attribute kIntegerValueAttribute;
+	/// @brief A Xentara attribute containing the current value of a floating point output.
+	static const model::Attribute kFloatingPointValueAttribute;
 
 private:
+	/// @brief The parts of the output that depend on the value type
+	template <typename DataType>
+	struct TypedState final
+	{
+		/// @brief The read state
+		PerValueReadState<DataType> _readState;
+		/// @brief The queue for the pending output value
+		SingleValueQueue<DataType> _pendingOutputValue;
+		/// @brief The queue for the pending output values if all values must be written, or nullptr if only the last
+		/// value is written.
+		std::unique_ptr<FifoQueue<DataType>> _pendingOutputFifo;
+	};
+
+	/// @brief Gets the value attribute that matches the value type
+	auto valueAttribute() const noexcept -> const model::Attribute &;
+
 	/// @brief Schedules a value to be written.
 	/// 
 	/// This function is called by the value write handle.
-	/// @todo use the correct value type
-	auto scheduleOutputValue(double value) noexcept
-	{
-		_pendingOutputValue.enqueue(value);
-	}
+	template <typename DataType>
+	auto scheduleOutputValue(DataType value) noexcept -> void;
 
 	/// @name Virtual Overrides for skill::DataPoint
 	/// @{
@@ -124,19 +159,27 @@ private:
 	/// @brief The I/O transaction this input belongs to, or nullptr if it hasn't been loaded yet.
 	/// @todo give this a more descriptive name, e.g. "_poll"
 	TemplateIoTransaction *_ioTransaction { nullptr };
-
-	/// @class xentara::plugins::templateDriver::TemplateOutput
-	/// @todo add information needed to decode the value from the payload of a read command, like e.g. a data offset.
-
-	/// @brief The read state
-	/// @todo use the correct value type
-	PerValueReadState<double> _readState;
+	/// @brief The index of this output within the I/O transaction
+	std::size_t _outputIndex { 0 };
+
+	/// @brief The type of the value
+	ValueType _valueType { ValueType::Double };
+	/// @brief The address of the value on the I/O component
+	std::uint64_t _address { 0 };
+	/// @brief The encoding of the value on the I/O component
+	Encoding _encoding { Encoding::Native };
+	/// @brief The scaling to apply to the raw value
+	Scaling _scaling;
+
+	/// @brief The read state and the output queues, for the type selected by _valueType
+	ValueTypeVariant<TypedState> _typedState;
 	/// @brief The write state
 	WriteState _writeState;
 
-	/// @brief The queue for the pending output value
-	/// @todo use the correct value type
-	SingleValueQueue<double> _pendingOutputValue;
+	/// @brief Whether all values are queued in a FIFO queue, rather than just the last one
+	bool _useFifo { false };
+	/// @brief The diagnostics for the FIFO queue
+	QueueDiagnostics _queueDiagnostics;
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
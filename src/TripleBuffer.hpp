@@ -0,0 +1,111 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A thread-safe buffer that holds the latest of a series of values, for types that are not lock-free atomics.
+///
+/// The values are copied into a small array of slots. One slot holds the latest value, one slot is used by the consumer
+/// while it copies the value out, and the remaining slots are used by producers to copy in new values. The latest value
+/// is handed over by exchanging the index of its slot, so the consumer never has to wait for a producer, and never sees
+/// a partially written value.
+///
+/// Any number of threads may store values. A producer only has to wait if more producers are storing values at the
+/// same time than there are spare slots.
+template <typename DataType>
+class TripleBuffer final
+{
+public:
+	/// @brief the value type
+	using value_type = DataType;
+
+	/// @brief Stores a value, replacing any value that has not been taken yet
+	auto store(const value_type &value) noexcept -> void
+	{
+		// Copy the value into a free slot
+		const auto slot = acquireSlot();
+		_slots[slot] = value;
+
+		// Publish the slot, and free the slot holding the value it replaces
+		if (const auto replaced = _latest.exchange(slot, std::memory_order_acq_rel); replaced != kNoSlot)
+		{
+			releaseSlot(replaced);
+		}
+	}
+
+	/// @brief Takes the latest value out of the buffer.
+	///
+	/// This function is wait-free.
+	/// @return The latest value or std::nullopt if no value was stored since the last call
+	auto take() noexcept -> std::optional<value_type>
+	{
+		// Take the slot holding the latest value
+		const auto slot = _latest.exchange(kNoSlot, std::memory_order_acq_rel);
+		if (slot == kNoSlot)
+		{
+			return std::nullopt;
+		}
+
+		// Copy out the value and free the slot
+		std::optional<value_type> value { _slots[slot] };
+		releaseSlot(slot);
+		return value;
+	}
+
+private:
+	/// @brief The number of slots. Three slots are needed for the latest value, the consumer, and a single producer.
+	/// The additional slot allows a second producer to store a value at the same time.
+	static constexpr std::size_t kSlotCount = 4;
+	/// @brief The index used to denote that there is no slot
+	static constexpr std::size_t kNoSlot = std::numeric_limits<std::size_t>::max();
+
+	/// @brief Takes a free slot
+	auto acquireSlot() noexcept -> std::size_t
+	{
+		auto freeSlots = _freeSlots.load(std::memory_order_relaxed);
+		while (true)
+		{
+			if (freeSlots == 0)
+			{
+				std::this_thread::yield();
+				freeSlots = _freeSlots.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			const auto slot = std::size_t(std::countr_zero(freeSlots));
+			if (_freeSlots.compare_exchange_weak(freeSlots, freeSlots & ~(std::uint32_t(1) << slot), std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				return slot;
+			}
+		}
+	}
+
+	/// @brief Returns a slot to the free slots
+	auto releaseSlot(std::size_t slot) noexcept -> void
+	{
+		_freeSlots.fetch_or(std::uint32_t(1) << slot, std::memory_order_release);
+	}
+
+	// The values are copied in and out of the slots
+	static_assert(std::is_trivially_copyable_v<value_type>);
+
+	/// @brief The slots
+	std::array<value_type, kSlotCount> _slots {};
+	/// @brief The slots that are free, one bit per slot
+	std::atomic<std::uint32_t> _freeSlots { (std::uint32_t(1) << kSlotCount) - 1 };
+	/// @brief The slot holding the latest value, or kNoSlot if the buffer is empty
+	std::atomic<std::size_t> _latest { kNoSlot };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
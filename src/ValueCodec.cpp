@@ -0,0 +1,61 @@
+// Copyright (c) embedded ocean GmbH
+#include "ValueCodec.hpp"
+
+#include <string_view>
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+auto parseEncoding(std::string_view name) noexcept -> std::optional<Encoding>
+{
+	if (name == "native"sv)
+	{
+		return Encoding::Native;
+	}
+	else if (name == "int8"sv)
+	{
+		return Encoding::Int8;
+	}
+	else if (name == "uint8"sv)
+	{
+		return Encoding::UInt8;
+	}
+	else if (name == "int16be"sv)
+	{
+		return Encoding::Int16BigEndian;
+	}
+	else if (name == "uint16be"sv)
+	{
+		return Encoding::UInt16BigEndian;
+	}
+	else if (name == "int32be"sv)
+	{
+		return Encoding::Int32BigEndian;
+	}
+	else if (name == "uint32be"sv)
+	{
+		return Encoding::UInt32BigEndian;
+	}
+	else if (name == "int64be"sv)
+	{
+		return Encoding::Int64BigEndian;
+	}
+	else if (name == "uint64be"sv)
+	{
+		return Encoding::UInt64BigEndian;
+	}
+	else if (name == "float32be"sv)
+	{
+		return Encoding::Float32BigEndian;
+	}
+	else if (name == "float64be"sv)
+	{
+		return Encoding::Float64BigEndian;
+	}
+
+	return std::nullopt;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,327 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The encodings that values can have in the payload of a read command
+/// @todo add any other encodings the I/O component supports
+enum class Encoding
+{
+	/// @brief The value's own type, in the native format of the host
+	Native,
+	/// @brief A signed 8-bit integer
+	Int8,
+	/// @brief An unsigned 8-bit integer
+	UInt8,
+	/// @brief A signed 16-bit integer in big-endian byte order
+	Int16BigEndian,
+	/// @brief An unsigned 16-bit integer in big-endian byte order
+	UInt16BigEndian,
+	/// @brief A signed 32-bit integer in big-endian byte order
+	Int32BigEndian,
+	/// @brief An unsigned 32-bit integer in big-endian byte order
+	UInt32BigEndian,
+	/// @brief A signed 64-bit integer in big-endian byte order
+	Int64BigEndian,
+	/// @brief An unsigned 64-bit integer in big-endian byte order
+	UInt64BigEndian,
+	/// @brief An IEEE 754 single precision number in big-endian byte order
+	Float32BigEndian,
+	/// @brief An IEEE 754 double precision number in big-endian byte order
+	Float64BigEndian
+};
+
+/// @brief Parses the name of an encoding, as used in the configuration
+/// @return The encoding, or std::nullopt if the name is unknown
+auto parseEncoding(std::string_view name) noexcept -> std::optional<Encoding>;
+
+/// @brief Gets the number of bytes a value with a certain encoding occupies
+/// @param encoding The encoding
+/// @param nativeSize The size of the value's own type, which is used for Encoding::Native
+constexpr auto encodedSize(Encoding encoding, std::size_t nativeSize) noexcept -> std::size_t
+{
+	switch (encoding)
+	{
+	case Encoding::Int8:
+	case Encoding::UInt8:
+		return 1;
+	case Encoding::Int16BigEndian:
+	case Encoding::UInt16BigEndian:
+		return 2;
+	case Encoding::Int32BigEndian:
+	case Encoding::UInt32BigEndian:
+	case Encoding::Float32BigEndian:
+		return 4;
+	case Encoding::Int64BigEndian:
+	case Encoding::UInt64BigEndian:
+	case Encoding::Float64BigEndian:
+		return 8;
+	case Encoding::Native:
+	default:
+		return nativeSize;
+	}
+}
+
+/// @brief A linear transformation applied to a value after decoding it
+struct Scaling
+{
+	/// @brief The factor to multiply the raw value with
+	double _factor { 1.0 };
+	/// @brief The offset to add after multiplying
+	double _offset { 0.0 };
+
+	/// @brief Checks whether the scaling leaves values unchanged
+	constexpr auto isIdentity() const noexcept -> bool
+	{
+		return _factor == 1.0 && _offset == 0.0;
+	}
+};
+
+/// @brief Loads an unsigned integer in big-endian byte order.
+///
+/// This function uses shifts instead of a byte swap, so that it works independently of the byte order of the host.
+/// Compilers recognize the pattern and generate a single load and byte swap instruction.
+template <std::unsigned_integral Integer>
+constexpr auto loadBigEndian(const std::byte *data) noexcept -> Integer
+{
+	Integer value { 0 };
+	for (std::size_t index = 0; index < sizeof(Integer); ++index)
+	{
+		value = Integer(value << 8) | Integer(data[index]);
+	}
+	return value;
+}
+
+/// @brief Stores an unsigned integer in big-endian byte order.
+///
+/// Like loadBigEndian(), this works independently of the byte order of the host.
+template <std::unsigned_integral Integer>
+constexpr auto storeBigEndian(Integer value, std::byte *data) noexcept -> void
+{
+	for (std::size_t index = sizeof(Integer); index > 0; --index)
+	{
+		data[index - 1] = std::byte(value & 0xff);
+		value = Integer(value >> 8);
+	}
+}
+
+/// @brief Converts a value to another type.
+///
+/// Conversions to bool yield *true* for any non-zero value. Conversions to integers round to the nearest integer, and
+/// saturate at the limits of the integer type. NaN is converted to 0.
+template <typename Target, typename Source>
+constexpr auto convertValue(Source value) noexcept -> Target
+{
+	if constexpr (std::same_as<Target, Source>)
+	{
+		return value;
+	}
+	else if constexpr (std::same_as<Target, bool>)
+	{
+		return value != Source(0);
+	}
+	else if constexpr (std::floating_point<Target> || std::same_as<Source, bool>)
+	{
+		return Target(value);
+	}
+	else if constexpr (std::integral<Source>)
+	{
+		if (std::cmp_less(value, std::numeric_limits<Target>::min()))
+		{
+			return std::numeric_limits<Target>::min();
+		}
+		if (std::cmp_greater(value, std::numeric_limits<Target>::max()))
+		{
+			return std::numeric_limits<Target>::max();
+		}
+		return Target(value);
+	}
+	else
+	{
+		if (std::isnan(value))
+		{
+			return 0;
+		}
+
+		// Compare against the limits as doubles. The maximum of a 64-bit integer is rounded up when converted to double,
+		// so values that compare equal are out of range, too.
+		const auto rounded = std::round(double(value));
+		if (rounded <= double(std::numeric_limits<Target>::min()))
+		{
+			return std::numeric_limits<Target>::min();
+		}
+		if (rounded >= double(std::numeric_limits<Target>::max()))
+		{
+			return std::numeric_limits<Target>::max();
+		}
+		return Target(rounded);
+	}
+}
+
+/// @brief The type of the raw value for an encoding
+/// @tparam kEncoding The encoding
+/// @tparam DataType The value's own type, which is used for Encoding::Native
+template <Encoding kEncoding, typename DataType>
+using RawType =
+	std::conditional_t<kEncoding == Encoding::Int8, std::int8_t,
+	std::conditional_t<kEncoding == Encoding::UInt8, std::uint8_t,
+	std::conditional_t<kEncoding == Encoding::Int16BigEndian, std::int16_t,
+	std::conditional_t<kEncoding == Encoding::UInt16BigEndian, std::uint16_t,
+	std::conditional_t<kEncoding == Encoding::Int32BigEndian, std::int32_t,
+	std::conditional_t<kEncoding == Encoding::UInt32BigEndian, std::uint32_t,
+	std::conditional_t<kEncoding == Encoding::Int64BigEndian, std::int64_t,
+	std::conditional_t<kEncoding == Encoding::UInt64BigEndian, std::uint64_t,
+	std::conditional_t<kEncoding == Encoding::Float32BigEndian, float,
+	std::conditional_t<kEncoding == Encoding::Float64BigEndian, double,
+	DataType>>>>>>>>>>;
+
+/// @brief Loads a raw value without applying any scaling
+/// @tparam kEncoding The encoding
+/// @tparam DataType The value's own type, which is used for Encoding::Native
+/// @param data The data, starting at the first byte of the value
+template <Encoding kEncoding, typename DataType>
+inline auto loadRaw(const std::byte *data) noexcept -> RawType<kEncoding, DataType>
+{
+	using Raw = RawType<kEncoding, DataType>;
+
+	// Copying an arbitrary byte into a bool is undefined behaviour, so treat any byte other than 0 as true
+	if constexpr (std::same_as<Raw, bool>)
+	{
+		return *data != std::byte(0);
+	}
+	else if constexpr (kEncoding == Encoding::Native || sizeof(Raw) == 1)
+	{
+		Raw value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	else
+	{
+		using Bits = std::conditional_t<sizeof(Raw) == 2, std::uint16_t, std::conditional_t<sizeof(Raw) == 4, std::uint32_t, std::uint64_t>>;
+		return std::bit_cast<Raw>(loadBigEndian<Bits>(data));
+	}
+}
+
+/// @brief Stores a raw value
+/// @tparam kEncoding The encoding
+/// @tparam DataType The value's own type, which is used for Encoding::Native
+/// @param value The value to store
+/// @param data Receives the value
+template <Encoding kEncoding, typename DataType>
+inline auto storeRaw(RawType<kEncoding, DataType> value, std::byte *data) noexcept -> void
+{
+	using Raw = RawType<kEncoding, DataType>;
+
+	if constexpr (kEncoding == Encoding::Native || sizeof(Raw) == 1)
+	{
+		std::memcpy(data, &value, sizeof(value));
+	}
+	else
+	{
+		using Bits = std::conditional_t<sizeof(Raw) == 2, std::uint16_t, std::conditional_t<sizeof(Raw) == 4, std::uint32_t, std::uint64_t>>;
+		storeBigEndian(std::bit_cast<Bits>(value), data);
+	}
+}
+
+/// @brief Calls a function template with the encoding as a template parameter
+/// @param encoding The encoding
+/// @param function A generic lambda with a single non-type template parameter of type Encoding
+template <typename Function>
+inline auto withEncoding(Encoding encoding, Function &&function) -> decltype(auto)
+{
+	switch (encoding)
+	{
+	case Encoding::Int8:
+		return function.template operator()<Encoding::Int8>();
+	case Encoding::UInt8:
+		return function.template operator()<Encoding::UInt8>();
+	case Encoding::Int16BigEndian:
+		return function.template operator()<Encoding::Int16BigEndian>();
+	case Encoding::UInt16BigEndian:
+		return function.template operator()<Encoding::UInt16BigEndian>();
+	case Encoding::Int32BigEndian:
+		return function.template operator()<Encoding::Int32BigEndian>();
+	case Encoding::UInt32BigEndian:
+		return function.template operator()<Encoding::UInt32BigEndian>();
+	case Encoding::Int64BigEndian:
+		return function.template operator()<Encoding::Int64BigEndian>();
+	case Encoding::UInt64BigEndian:
+		return function.template operator()<Encoding::UInt64BigEndian>();
+	case Encoding::Float32BigEndian:
+		return function.template operator()<Encoding::Float32BigEndian>();
+	case Encoding::Float64BigEndian:
+		return function.template operator()<Encoding::Float64BigEndian>();
+	case Encoding::Native:
+	default:
+		return function.template operator()<Encoding::Native>();
+	}
+}
+
+/// @brief Decodes a value and applies the scaling
+///
+/// If the scaling is the identity, the raw value is converted directly, so that 64-bit integers keep their full precision.
+/// Otherwise, the scaling is applied in double precision.
+/// @tparam DataType The value's own type
+/// @tparam kEncoding The encoding of the value
+/// @param data The data, starting at the first byte of the value
+/// @param factor The scaling factor
+/// @param offset The scaling offset
+template <typename DataType, Encoding kEncoding>
+inline auto decodeValue(const std::byte *data, double factor, double offset) noexcept -> DataType
+{
+	const auto raw = loadRaw<kEncoding, DataType>(data);
+	if (factor == 1.0 && offset == 0.0)
+	{
+		return convertValue<DataType>(raw);
+	}
+	return convertValue<DataType>(double(raw) * factor + offset);
+}
+
+/// @brief Encodes a value for the payload of a write command
+///
+/// The scaling is reversed before encoding, so that a value that is decoded using the same scaling yields the original value.
+/// Integer encodings round to the nearest integer and saturate at the limits of the integer type.
+/// @param encoding The encoding to use
+/// @param value The value to encode
+/// @param scaling The scaling that is applied when the value is decoded
+/// @param data Receives the encoded value. This must point to at least encodedSize(encoding, sizeof(DataType)) bytes.
+template <typename DataType>
+inline auto encodeValue(Encoding encoding, DataType value, const Scaling &scaling, std::byte *data) noexcept -> void
+{
+	withEncoding(encoding, [&]<Encoding kEncoding>()
+		{
+			using Raw = RawType<kEncoding, DataType>;
+			if (scaling.isIdentity())
+			{
+				storeRaw<kEncoding, DataType>(convertValue<Raw>(value), data);
+			}
+			else
+			{
+				// Reverse the scaling
+				storeRaw<kEncoding, DataType>(convertValue<Raw>((double(value) - scaling._offset) / scaling._factor), data);
+			}
+		});
+}
+
+/// @brief Decodes a raw value as a double without applying any scaling
+/// @param data The data, starting at the first byte of the value
+template <Encoding kEncoding>
+inline auto decodeRaw(const std::byte *data) noexcept -> double
+{
+	return double(loadRaw<kEncoding, double>(data));
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,59 @@
+// Copyright (c) embedded ocean GmbH
+#include "ValueType.hpp"
+
+namespace xentara::plugins::templateDriver
+{
+
+using namespace std::literals;
+
+auto parseValueType(std::string_view name) noexcept -> std::optional<ValueType>
+{
+	if (name == "bool"sv)
+	{
+		return ValueType::Boolean;
+	}
+	else if (name == "int8"sv)
+	{
+		return ValueType::Int8;
+	}
+	else if (name == "uint8"sv)
+	{
+		return ValueType::UInt8;
+	}
+	else if (name == "int16"sv)
+	{
+		return ValueType::Int16;
+	}
+	else if (name == "uint16"sv)
+	{
+		return ValueType::UInt16;
+	}
+	else if (name == "int32"sv)
+	{
+		return ValueType::Int32;
+	}
+	else if (name == "uint32"sv)
+	{
+		return ValueType::UInt32;
+	}
+	else if (name == "int64"sv)
+	{
+		return ValueType::Int64;
+	}
+	else if (name == "uint64"sv)
+	{
+		return ValueType::UInt64;
+	}
+	else if (name == "float"sv)
+	{
+		return ValueType::Float;
+	}
+	else if (name == "double"sv)
+	{
+		return ValueType::Double;
+	}
+
+	return std::nullopt;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,108 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief The types of the values of inputs and outputs
+/// @note The order of the enumerators must match the order of the types in ForEachValueType.
+enum class ValueType
+{
+	/// @brief A boolean value
+	Boolean,
+	/// @brief A signed 8-bit integer
+	Int8,
+	/// @brief An unsigned 8-bit integer
+	UInt8,
+	/// @brief A signed 16-bit integer
+	Int16,
+	/// @brief An unsigned 16-bit integer
+	UInt16,
+	/// @brief A signed 32-bit integer
+	Int32,
+	/// @brief An unsigned 32-bit integer
+	UInt32,
+	/// @brief A signed 64-bit integer
+	Int64,
+	/// @brief An unsigned 64-bit integer
+	UInt64,
+	/// @brief A single precision floating point number
+	Float,
+	/// @brief A double precision floating point number
+	Double
+};
+
+/// @brief Parses the name of a value type, as used in the configuration
+/// @return The value type, or std::nullopt if the name is unknown
+auto parseValueType(std::string_view name) noexcept -> std::optional<ValueType>;
+
+/// @brief Instantiates a template for each C++ type that corresponds to a ValueType, and collects them in a list type.
+///
+/// The types are listed in the order of the ValueType enumerators.
+/// @tparam List The list template, e.g. std::variant or std::tuple
+/// @tparam Template The template to instantiate for each type
+template <template <typename...> class List, template <typename> class Template>
+using ForEachValueType = List<
+	Template<bool>,
+	Template<std::int8_t>,
+	Template<std::uint8_t>,
+	Template<std::int16_t>,
+	Template<std::uint16_t>,
+	Template<std::int32_t>,
+	Template<std::uint32_t>,
+	Template<std::int64_t>,
+	Template<std::uint64_t>,
+	Template<float>,
+	Template<double>>;
+
+/// @brief A variant that holds an instance of a template for one of the value types
+template <template <typename> class Template>
+using ValueTypeVariant = ForEachValueType<std::variant, Template>;
+
+/// @brief A tuple that holds an instance of a template for each of the value types
+template <template <typename> class Template>
+using ValueTypeTuple = ForEachValueType<std::tuple, Template>;
+
+/// @brief Replaces the contents of a ValueTypeVariant with a default constructed instance for a certain value type
+template <typename Variant>
+auto emplaceValueType(Variant &variant, ValueType valueType) -> void
+{
+	[&]<std::size_t... kIndices>(std::index_sequence<kIndices...>)
+	{
+		((std::size_t(valueType) == kIndices && (variant.template emplace<kIndices>(), true)) || ...);
+	}(std::make_index_sequence<std::variant_size_v<Variant>>());
+}
+
+/// @brief Gets the size of the native representation of a value type
+constexpr auto valueSize(ValueType valueType) noexcept -> std::size_t
+{
+	switch (valueType)
+	{
+	case ValueType::Boolean:
+	case ValueType::Int8:
+	case ValueType::UInt8:
+		return 1;
+	case ValueType::Int16:
+	case ValueType::UInt16:
+		return 2;
+	case ValueType::Int32:
+	case ValueType::UInt32:
+	case ValueType::Float:
+		return 4;
+	case ValueType::Int64:
+	case ValueType::UInt64:
+	case ValueType::Double:
+	default:
+		return 8;
+	}
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
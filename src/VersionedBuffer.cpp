@@ -0,0 +1,73 @@
+// Copyright (c) embedded ocean GmbH
+#include "VersionedBuffer.hpp"
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto VersionedBuffer::reset(std::size_t size, std::size_t slotCount) -> void
+{
+	_size = size;
+	_slotCount = std::clamp(slotCount, kMinSlotCount, kMaxSlotCount);
+	const auto linesPerSlot = std::max<std::size_t>((size + kCacheLineSize - 1) / kCacheLineSize, 1);
+	_slotStride = linesPerSlot * kCacheLineSize;
+
+	// Value-initialize everything, which fills the data with zeros and sets the counters to 0
+	_storage = std::make_unique<CacheLine[]>(linesPerSlot * _slotCount);
+	_released = std::make_unique<ReleaseCounter[]>(_slotCount);
+	_pinned = std::make_unique<std::uint64_t[]>(_slotCount);
+	_writeSlot = kNoSlot;
+	_skippedCount.store(0, std::memory_order_relaxed);
+
+	// Slot 0 holds the initial version
+	_current.store(0, std::memory_order_relaxed);
+}
+
+auto VersionedBuffer::read() const noexcept -> Reader
+{
+	// Pin the current slot by counting ourselves as one of its readers. The acquire makes the data of the slot visible.
+	const auto slot = std::size_t(_current.fetch_add(1, std::memory_order_acquire) >> kSlotShift);
+
+	return Reader(*this, slot, slotData(slot));
+}
+
+auto VersionedBuffer::beginWrite() noexcept -> std::span<std::byte>
+{
+	const auto currentSlot = std::size_t(_current.load(std::memory_order_relaxed) >> kSlotShift);
+
+	// Find a slot that all the readers that pinned it have released. The acquire makes sure the readers are done with it.
+	for (std::size_t slot = 0; slot < _slotCount; ++slot)
+	{
+		if (slot == currentSlot || _released[slot]._count.load(std::memory_order_acquire) != _pinned[slot])
+		{
+			continue;
+		}
+
+		// No reader can pin the slot any more, because it is not current, so the counters can safely be reset
+		_released[slot]._count.store(0, std::memory_order_relaxed);
+		_pinned[slot] = 0;
+
+		// Start with the data of the current version
+		_writeSlot = slot;
+		const auto data = slotData(slot);
+		std::ranges::copy(slotData(currentSlot), data.begin());
+		return data;
+	}
+
+	// All the slots are pinned
+	_skippedCount.fetch_add(1, std::memory_order_relaxed);
+	return {};
+}
+
+auto VersionedBuffer::publish() noexcept -> void
+{
+	// Make the new slot current. The release makes its data visible to the readers that pin it.
+	const auto previous = _current.exchange(std::uint64_t(_writeSlot) << kSlotShift, std::memory_order_acq_rel);
+
+	// Remember how many readers pinned the previous slot, so we know when they have all released it
+	_pinned[std::size_t(previous >> kSlotShift)] = previous & kReaderMask;
+	_writeSlot = kNoSlot;
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
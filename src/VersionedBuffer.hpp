@@ -0,0 +1,199 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include "DataLayout.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief A block of data that is kept in several versions, so that readers never block the writer, and the writer never
+/// waits for readers.
+///
+/// Each version is stored in a slot of its own. A reader pins the current slot using a single atomic increment of a
+/// word that holds both the index of the current slot and the number of readers that pinned it, and releases the slot
+/// using a single atomic increment of the slot's release counter. Reading is therefore wait-free, no matter how many
+/// readers there are.
+///
+/// The writer copies each new version into a slot that is neither current nor pinned by any reader, and then publishes it
+/// by exchanging the current slot index. The reader count that the exchange returns tells the writer how many readers
+/// must release the old slot before it can be reused. If slow readers still pin all the other slots, the new version
+/// cannot be written. beginWrite() reports this, and readers keep seeing the previous version until the writer
+/// succeeds with a later one. The writer never waits.
+///
+/// There must only be a single writer, but any number of threads may read at the same time.
+class VersionedBuffer final
+{
+public:
+	/// @brief The default number of slots
+	static constexpr std::size_t kDefaultSlotCount = 4;
+	/// @brief The minimum number of slots
+	static constexpr std::size_t kMinSlotCount = 2;
+	/// @brief The maximum number of slots
+	static constexpr std::size_t kMaxSlotCount = 64;
+
+	/// @brief Gives a reader access to the version that was current when it was created
+	///
+	/// The version stays pinned, and is not overwritten, until the reader is destroyed.
+	class Reader final
+	{
+	public:
+		/// @brief Move constructor
+		Reader(Reader &&other) noexcept :
+			_buffer(std::exchange(other._buffer, nullptr)), _slot(other._slot), _data(other._data)
+		{
+		}
+
+		/// @brief Move assignment operator
+		auto operator=(Reader &&rhs) noexcept -> Reader &
+		{
+			if (this != &rhs)
+			{
+				release();
+				_buffer = std::exchange(rhs._buffer, nullptr);
+				_slot = rhs._slot;
+				_data = rhs._data;
+			}
+			return *this;
+		}
+
+		/// @brief Releases the version
+		~Reader()
+		{
+			release();
+		}
+
+		/// @brief Gets the data of the version
+		auto data() const noexcept -> std::span<const std::byte>
+		{
+			return _data;
+		}
+
+	private:
+		/// @brief Creates a reader for a pinned slot
+		Reader(const VersionedBuffer &buffer, std::size_t slot, std::span<const std::byte> data) noexcept :
+			_buffer(&buffer), _slot(slot), _data(data)
+		{
+		}
+
+		/// @brief Releases the slot, if it is still pinned
+		auto release() noexcept -> void
+		{
+			if (_buffer)
+			{
+				_buffer->release(_slot);
+				_buffer = nullptr;
+			}
+		}
+
+		/// @brief The buffer the slot belongs to, or nullptr if the reader was moved from
+		const VersionedBuffer *_buffer;
+		/// @brief The pinned slot
+		std::size_t _slot;
+		/// @brief The data of the pinned slot
+		std::span<const std::byte> _data;
+
+		friend class VersionedBuffer;
+	};
+
+	/// @brief Allocates the slots, and fills the current version with zeros.
+	///
+	/// This must not be called while other threads are using the buffer.
+	/// @param size The size of the data, in bytes
+	/// @param slotCount The number of slots. This is clamped to the range kMinSlotCount to kMaxSlotCount. The writer can always
+	/// publish a new version as long as fewer than slotCount - 1 versions are pinned by readers.
+	auto reset(std::size_t size, std::size_t slotCount = kDefaultSlotCount) -> void;
+
+	/// @brief Gets the size of the data, in bytes
+	auto size() const noexcept -> std::size_t
+	{
+		return _size;
+	}
+
+	/// @brief Pins the current version for reading.
+	///
+	/// This function is wait-free, and may be called from any thread.
+	auto read() const noexcept -> Reader;
+
+	/// @brief Starts writing a new version.
+	///
+	/// The data of the current version is copied into a free slot, so that the writer only has to change the parts that differ.
+	/// This function must only be called by the writer.
+	/// @return The data of the new version, or an empty span if readers still pin all the slots. If the span is not empty,
+	/// publish() must be called once the data has been written.
+	auto beginWrite() noexcept -> std::span<std::byte>;
+
+	/// @brief Makes the version started using beginWrite() the current version
+	///
+	/// This function must only be called by the writer.
+	auto publish() noexcept -> void;
+
+	/// @brief Gets the number of versions that could not be written, because readers pinned all the slots
+	auto skippedCount() const noexcept -> std::uint64_t
+	{
+		return _skippedCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	/// @brief The index used to denote that there is no slot
+	static constexpr std::size_t kNoSlot = ~std::size_t(0);
+	/// @brief The position of the slot index in _current. The bits below hold the number of readers.
+	static constexpr unsigned kSlotShift = 48;
+	/// @brief The mask for the number of readers in _current
+	static constexpr std::uint64_t kReaderMask = (std::uint64_t(1) << kSlotShift) - 1;
+
+	/// @brief A cache line of storage, used to keep the slots and counters on cache lines of their own
+	struct alignas(kCacheLineSize) CacheLine final
+	{
+		/// @brief The bytes
+		std::byte _bytes[kCacheLineSize];
+	};
+
+	/// @brief The release counter of a slot, on a cache line of its own so that readers of different slots do not contend
+	struct alignas(kCacheLineSize) ReleaseCounter final
+	{
+		/// @brief The number of readers that released the slot since it was last written
+		std::atomic<std::uint64_t> _count { 0 };
+	};
+
+	/// @brief Gets the data of a slot
+	auto slotData(std::size_t slot) const noexcept -> std::span<std::byte>
+	{
+		return { _storage.get()->_bytes + slot * _slotStride, _size };
+	}
+
+	/// @brief Releases a slot pinned by a reader
+	auto release(std::size_t slot) const noexcept -> void
+	{
+		_released[slot]._count.fetch_add(1, std::memory_order_release);
+	}
+
+	/// @brief The size of the data
+	std::size_t _size { 0 };
+	/// @brief The distance between two slots, which is a multiple of the cache line size
+	std::size_t _slotStride { 0 };
+	/// @brief The number of slots
+	std::size_t _slotCount { 0 };
+	/// @brief The storage for the data of all slots
+	std::unique_ptr<CacheLine[]> _storage;
+	/// @brief The release counters, one for each slot
+	std::unique_ptr<ReleaseCounter[]> _released;
+	/// @brief The number of readers that pinned each slot while it was current. This is only used by the writer.
+	std::unique_ptr<std::uint64_t[]> _pinned;
+	/// @brief The slot being written, or kNoSlot if no version was started
+	std::size_t _writeSlot { kNoSlot };
+	/// @brief The number of versions that could not be written
+	std::atomic<std::uint64_t> _skippedCount { 0 };
+
+	/// @brief The index of the current slot in the upper bits, and the number of readers that pinned it in the lower bits
+	/// @note This is aligned to a cache line, so that readers pinning a version do not contend with anything else
+	alignas(kCacheLineSize) mutable std::atomic<std::uint64_t> _current { 0 };
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
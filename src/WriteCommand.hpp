@@ -3,13 +3,45 @@
 
 #include <xentara/utils/tools/Unique.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
 namespace xentara::plugins::templateDriver
 {
 
 /// @brief A command used to write outputs
+///
+/// Each command writes a single contiguous address range. The command does not own its data, which is stored
+/// in the shadow image of the WriteCommandBuilder that created it.
 /// @todo implement a proper write command
 class WriteCommand final : private utils::tools::Unique
 {
+public:
+	/// @brief Constructor
+	/// @param address The address of the first byte to write
+	/// @param data The data to write. The data is not copied, so the buffer must outlive the command.
+	constexpr WriteCommand(std::uint64_t address, std::span<const std::byte> data) noexcept : _address(address), _data(data)
+	{
+	}
+
+	/// @brief Gets the address of the first byte to write
+	constexpr auto address() const noexcept -> std::uint64_t
+	{
+		return _address;
+	}
+
+	/// @brief Gets the data to write
+	constexpr auto data() const noexcept -> std::span<const std::byte>
+	{
+		return _data;
+	}
+
+private:
+	/// @brief The address of the first byte to write
+	std::uint64_t _address { 0 };
+	/// @brief The data to write
+	std::span<const std::byte> _data;
 };
 
 } // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,137 @@
+// Copyright (c) embedded ocean GmbH
+#include "WriteCommandBuilder.hpp"
+
+#include <algorithm>
+
+namespace xentara::plugins::templateDriver
+{
+
+auto WriteCommandBuilder::addOutput(std::uint64_t address, std::size_t size) -> std::size_t
+{
+	const auto outputIndex = _slots.size();
+	_slots.push_back({ ._address = address, ._size = size, ._outputIndex = outputIndex });
+	return outputIndex;
+}
+
+auto WriteCommandBuilder::compile() -> void
+{
+	// Sort the slots by address
+	std::ranges::stable_sort(_slots, {}, &Slot::_address);
+
+	// Outputs must not overlap, because each byte of the I/O component can only be written with one value
+	for (std::size_t index = 1; index < _slots.size(); ++index)
+	{
+		const auto &previous = _slots[index - 1];
+		if (_slots[index]._address < previous._address + previous._size)
+		{
+			/// @todo replace "template outputs" and "I/O transaction" with more descriptive names
+			throw std::runtime_error("the addresses of two template outputs in the same I/O transaction overlap");
+		}
+	}
+
+	// Lay out the shadow image in address order, so that the data of adjacent outputs is contiguous
+	std::size_t shadowSize = 0;
+	_slotIndices.resize(_slots.size());
+	for (std::size_t index = 0; index < _slots.size(); ++index)
+	{
+		auto &slot = _slots[index];
+		slot._shadowOffset = shadowSize;
+		shadowSize += slot._size;
+		_slotIndices[slot._outputIndex] = index;
+	}
+	_shadowImage.assign(shadowSize, std::byte(0));
+
+	// Preallocate the runtime buffers
+	_pending.reserve(_slots.size());
+	_frames.reserve(_slots.size());
+}
+
+auto WriteCommandBuilder::stage(std::size_t outputIndex) noexcept -> std::span<std::byte>
+{
+	// Find the slot
+	const auto slotIndex = _slotIndices[outputIndex];
+	auto &slot = _slots[slotIndex];
+
+	// Mark it as pending
+	if (!slot._pending)
+	{
+		slot._pending = true;
+		_pending.push_back(slotIndex);
+	}
+
+	return std::span(_shadowImage).subspan(slot._shadowOffset, slot._size);
+}
+
+auto WriteCommandBuilder::build() noexcept -> std::span<const Frame>
+{
+	// Visit the pending slots by address. The slots are sorted by address, so their indices are, too.
+	std::ranges::sort(_pending);
+
+	_frames.clear();
+	std::size_t last = 0;
+	for (auto &&index : _pending)
+	{
+		const auto &slot = _slots[index];
+
+		// Try to extend the current frame
+		if (!_frames.empty() && canExtend(last, index, _frames.back()))
+		{
+			_frames.back()._size = std::size_t(slot._address + slot._size - _frames.back()._address);
+			last = index;
+			continue;
+		}
+
+		// Start a new frame
+		_frames.push_back({ ._address = slot._address, ._shadowOffset = slot._shadowOffset, ._size = slot._size });
+		last = index;
+	}
+
+	return _frames;
+}
+
+auto WriteCommandBuilder::canExtend(std::size_t last, std::size_t next, const Frame &frame) const noexcept -> bool
+{
+	// Check the size limit
+	const auto &nextSlot = _slots[next];
+	if (nextSlot._address + nextSlot._size - frame._address > _maxCommandSize)
+	{
+		return false;
+	}
+
+	// Every slot up to the next pending one must directly follow its predecessor, and the slots in between
+	// must have valid shadow values that fit into the maximum gap.
+	std::size_t gap = 0;
+	for (auto index = last + 1; index <= next; ++index)
+	{
+		const auto &previous = _slots[index - 1];
+		const auto &slot = _slots[index];
+		if (slot._address != previous._address + previous._size)
+		{
+			return false;
+		}
+
+		if (index != next)
+		{
+			gap += slot._size;
+			if (!slot._valid || gap > _maxGap)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+auto WriteCommandBuilder::finish(bool success) noexcept -> void
+{
+	for (auto &&index : _pending)
+	{
+		auto &slot = _slots[index];
+		slot._pending = false;
+		slot._valid = success;
+	}
+	_pending.clear();
+}
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <span>
+#include <vector>
+
+namespace xentara::plugins::templateDriver
+{
+
+/// @brief Builds the write commands for the pending outputs of an I/O transaction
+///
+/// The builder keeps a shadow image containing the last value written to each output, laid out in order of ascending
+/// address. Pending outputs encode their values directly into the shadow image. When the commands are built, the pending
+/// outputs are visited by address, and outputs whose data directly follow each other are merged into a single frame.
+/// If the I/O component allows it, small gaps between pending outputs are bridged by rewriting the shadow values of the
+/// outputs in between, so that a burst of changes can be written using only a few frames.
+///
+/// A shadow value is only used to bridge a gap if it was written successfully before. Bytes that do not belong to
+/// any output are never written.
+class WriteCommandBuilder final
+{
+public:
+	/// @brief The default maximum gap, which does not allow any gaps to be bridged.
+	/// @todo adjust this if the actual device allows unchanged values to be written again
+	static constexpr std::size_t kDefaultMaxGap = 0;
+	/// @brief The default maximum command size, which is unlimited.
+	/// @todo adjust this to the maximum frame size of the actual device
+	static constexpr std::size_t kDefaultMaxCommandSize = std::numeric_limits<std::size_t>::max();
+
+	/// @brief A contiguous address range that is written using a single write command
+	struct Frame
+	{
+		/// @brief The address of the first byte to write
+		std::uint64_t _address { 0 };
+		/// @brief The offset of the data within the shadow image
+		std::size_t _shadowOffset { 0 };
+		/// @brief The number of bytes to write
+		std::size_t _size { 0 };
+	};
+
+	/// @brief Sets the maximum number of bytes of shadow values that may be rewritten to bridge a gap between pending outputs
+	auto setMaxGap(std::size_t maxGap) noexcept -> void
+	{
+		_maxGap = maxGap;
+	}
+
+	/// @brief Sets the maximum number of bytes a single command may write
+	auto setMaxCommandSize(std::size_t maxCommandSize) noexcept -> void
+	{
+		_maxCommandSize = maxCommandSize;
+	}
+
+	/// @brief Adds an output
+	/// @param address The address of the output's data
+	/// @param size The size of the output's data
+	/// @return The index of the output, which must be passed to stage(). Outputs are numbered in the order they were added.
+	auto addOutput(std::uint64_t address, std::size_t size) -> std::size_t;
+
+	/// @brief Lays out the shadow image and preallocates all the buffers needed to build commands.
+	///
+	/// This must be called after all outputs have been added.
+	/// @throw std::runtime_error The address ranges of two outputs overlap
+	auto compile() -> void;
+
+	/// @brief Marks an output as pending
+	/// @param outputIndex The index returned by addOutput()
+	/// @return The output's data in the shadow image, which the caller must fill in with the encoded value.
+	/// The span has exactly the size that was passed to addOutput().
+	auto stage(std::size_t outputIndex) noexcept -> std::span<std::byte>;
+
+	/// @brief Merges the pending outputs into frames
+	/// @return The frames to write, in order of ascending address
+	auto build() noexcept -> std::span<const Frame>;
+
+	/// @brief Gets the data for a frame
+	auto data(const Frame &frame) const noexcept -> std::span<const std::byte>
+	{
+		return std::span(_shadowImage).subspan(frame._shadowOffset, frame._size);
+	}
+
+	/// @brief Finishes writing the frames returned by build(), and clears the pending outputs
+	/// @param success Whether the frames were written successfully. If not, the shadow values of the pending
+	/// outputs are no longer used to bridge gaps, as they may not match the values in the I/O component.
+	auto finish(bool success) noexcept -> void;
+
+private:
+	/// @brief The data of an output within the shadow image
+	struct Slot
+	{
+		/// @brief The address of the data
+		std::uint64_t _address { 0 };
+		/// @brief The size of the data
+		std::size_t _size { 0 };
+		/// @brief The offset of the data within the shadow image
+		std::size_t _shadowOffset { 0 };
+		/// @brief The index of the output, as returned by addOutput()
+		std::size_t _outputIndex { 0 };
+		/// @brief Whether the shadow value was written successfully, and may be used to bridge gaps
+		bool _valid { false };
+		/// @brief Whether the output is pending
+		bool _pending { false };
+	};
+
+	/// @brief Checks whether a frame can be extended from one pending slot to a later one
+	/// @param last The index of the last slot in the frame
+	/// @param next The index of the slot to extend the frame to
+	/// @param frame The frame
+	auto canExtend(std::size_t last, std::size_t next, const Frame &frame) const noexcept -> bool;
+
+	/// @brief The maximum number of bytes of shadow values that may be rewritten to bridge a gap
+	std::size_t _maxGap { kDefaultMaxGap };
+	/// @brief The maximum number of bytes a single command may write
+	std::size_t _maxCommandSize { kDefaultMaxCommandSize };
+
+	/// @brief The slots of all outputs, sorted by address
+	std::vector<Slot> _slots;
+	/// @brief The index of the slot of each output, indexed by output index
+	std::vector<std::size_t> _slotIndices;
+	/// @brief The shadow image
+	std::vector<std::byte> _shadowImage;
+	/// @brief The indices of the pending slots
+	std::vector<std::size_t> _pending;
+	/// @brief The frames returned by build()
+	std::vector<Frame> _frames;
+};
+
+} // namespace xentara::plugins::templateDriver
\ No newline at end of file
@@ -0,0 +1,121 @@
+// Copyright (c) embedded ocean GmbH
+#include "Check.hpp"
+
+#include "BatchDecoder.hpp"
+#include "ChangeDetection.hpp"
+#include "ValueCodec.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief Checks that decoding a batch yields the same values as decoding each value on its own
+	auto checkBatch(InstructionSet instructionSet, Encoding encoding, std::size_t count, std::mt19937 &random) -> void
+	{
+		const auto size = encodedSize(encoding, sizeof(double));
+
+		// Fill the source with random bytes, and pick random scalings
+		std::vector<std::byte> source(count * size);
+		for (auto &&byte : source)
+		{
+			byte = std::byte(random() & 0xff);
+		}
+		std::vector<double> factors(count);
+		std::vector<double> offsets(count);
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			factors[index] = index % 3 == 0 ? 1.0 : double(random() % 1000) / 100.0;
+			offsets[index] = index % 3 == 0 ? 0.0 : double(random() % 1000) - 500.0;
+		}
+
+		// Decode the batch
+		std::vector<double> values(count);
+		decodeBatch(
+			instructionSet, encoding, source, std::span<const double>(factors), std::span<const double>(offsets), std::span(values));
+
+		// Compare against the scalar decoder. NaN never compares equal, so compare the bit patterns.
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			const auto expected = withEncoding(encoding, [&]<Encoding kEncoding>()
+				{ return decodeValue<double, kEncoding>(source.data() + index * size, factors[index], offsets[index]); });
+			check(std::bit_cast<std::uint64_t>(values[index]) == std::bit_cast<std::uint64_t>(expected), "batch matches scalar decoder");
+		}
+	}
+
+	/// @brief Checks the change mask for a few known changes
+	auto checkChangeMask() -> void
+	{
+		std::vector<double> previous(130, 1.0);
+		auto current = previous;
+		current[0] = 2.0;
+		current[64] = 2.0;
+		current[129] = 2.0;
+
+		std::vector<std::uint64_t> mask(changeMaskSize(current.size()));
+		detectChanges(std::span<const double>(previous), std::span<const double>(current), std::span(mask));
+
+		for (std::size_t index = 0; index < current.size(); ++index)
+		{
+			check(isChanged(mask, index) == (index == 0 || index == 64 || index == 129), "change mask marks exactly the changed values");
+		}
+	}
+
+	/// @brief Checks that natively encoded bools treat any byte other than 0 as true
+	auto checkNativeBool() -> void
+	{
+		for (const auto byte : { 0x00, 0x01, 0x02, 0x80, 0xff })
+		{
+			const auto data = std::byte(byte);
+			check(decodeValue<bool, Encoding::Native>(&data, 1.0, 0.0) == (byte != 0), "native bool is true for any byte other than 0");
+		}
+	}
+
+} // namespace
+
+auto main() -> int
+{
+	std::mt19937 random(42);
+
+	// Check each of the implementations the CPU supports
+	const auto supported = supportedInstructionSet();
+	for (const auto instructionSet : { InstructionSet::Scalar, InstructionSet::Sse41, InstructionSet::Avx2 })
+	{
+		if (instructionSet > supported)
+		{
+			break;
+		}
+
+		// Use counts that are not multiples of the vector width, so that the scalar remainder is exercised as well
+		for (const auto encoding : { Encoding::Native,
+				 Encoding::Int8,
+				 Encoding::UInt8,
+				 Encoding::Int16BigEndian,
+				 Encoding::UInt16BigEndian,
+				 Encoding::Int32BigEndian,
+				 Encoding::UInt32BigEndian,
+				 Encoding::Int64BigEndian,
+				 Encoding::UInt64BigEndian,
+				 Encoding::Float32BigEndian,
+				 Encoding::Float64BigEndian })
+		{
+			for (const std::size_t count : { 0, 1, 3, 4, 7, 8, 17, 64, 101 })
+			{
+				checkBatch(instructionSet, encoding, count, random);
+			}
+		}
+	}
+
+	checkChangeMask();
+	checkNativeBool();
+
+	return exitCode();
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace xentara::plugins::templateDriver::tests
+{
+
+/// @brief Gets the number of iterations to run from the command line
+/// @param argc The argument count passed to main()
+/// @param argv The arguments passed to main()
+/// @param defaultCount The number of iterations to run if none was specified
+inline auto iterationCount(int argc, char **argv, std::size_t defaultCount) -> std::size_t
+{
+	if (argc > 1)
+	{
+		return std::strtoull(argv[1], nullptr, 10);
+	}
+	return defaultCount;
+}
+
+/// @brief Keeps the compiler from optimizing away a computation whose result is otherwise unused
+template <typename Value>
+inline auto doNotOptimize(const Value &value) noexcept -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const Value *sink;
+	sink = &value;
+#endif
+}
+
+/// @brief Measures how long a function takes, and prints the time per iteration
+/// @param name The name to print
+/// @param iterations The number of times to call the function
+/// @param function The function
+/// @return The time per iteration, in nanoseconds
+template <typename Function>
+auto measure(std::string_view name, std::size_t iterations, Function &&function) -> double
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+	{
+		function();
+	}
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+	const auto perIteration = iterations > 0 ? elapsed.count() / double(iterations) : 0.0;
+	std::printf("%-40.*s %12.1f ns/iteration\n", int(name.size()), name.data(), perIteration);
+	return perIteration;
+}
+
+/// @brief Measures how long a function takes, not counting a preparation step that runs before each call, and prints the time per iteration
+/// @param name The name to print
+/// @param iterations The number of times to call the function
+/// @param prepare A function called before each call to the function, which is not included in the time
+/// @param function The function
+/// @return The time per iteration, in nanoseconds
+template <typename Prepare, typename Function>
+auto measure(std::string_view name, std::size_t iterations, Prepare &&prepare, Function &&function) -> double
+{
+	std::chrono::duration<double, std::nano> elapsed { 0 };
+	for (std::size_t iteration = 0; iteration < iterations; ++iteration)
+	{
+		prepare();
+
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		elapsed += std::chrono::steady_clock::now() - start;
+	}
+
+	const auto perIteration = iterations > 0 ? elapsed.count() / double(iterations) : 0.0;
+	std::printf("%-40.*s %12.1f ns/iteration\n", int(name.size()), name.data(), perIteration);
+	return perIteration;
+}
+
+} // namespace xentara::plugins::templateDriver::tests
\ No newline at end of file
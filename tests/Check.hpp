@@ -0,0 +1,40 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cstdio>
+#include <source_location>
+#include <string_view>
+
+namespace xentara::plugins::templateDriver::tests
+{
+
+/// @brief The number of checks that failed
+inline int gFailedCheckCount = 0;
+
+/// @brief Checks a condition, and reports a failure if it does not hold
+/// @param condition The condition
+/// @param description A description of what is checked
+/// @param location The location of the check
+inline auto check(bool condition, std::string_view description, std::source_location location = std::source_location::current())
+	-> void
+{
+	if (!condition)
+	{
+		std::fprintf(stderr, "%s:%u: check failed: %.*s\n", location.file_name(), unsigned(location.line()), int(description.size()),
+			description.data());
+		++gFailedCheckCount;
+	}
+}
+
+/// @brief Gets the exit code for main(), which is non-zero if any check failed
+inline auto exitCode() -> int
+{
+	if (gFailedCheckCount > 0)
+	{
+		std::fprintf(stderr, "%d check(s) failed\n", gFailedCheckCount);
+		return 1;
+	}
+	return 0;
+}
+
+} // namespace xentara::plugins::templateDriver::tests
\ No newline at end of file
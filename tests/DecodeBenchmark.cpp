@@ -0,0 +1,255 @@
+// Copyright (c) embedded ocean GmbH
+#include "Benchmark.hpp"
+#include "Check.hpp"
+
+#include "ChangeDetection.hpp"
+#include "CommonReadState.hpp"
+#include "DecodeTable.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+#include "Types.hpp"
+#include "ValueCodec.hpp"
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/ArrayBlock.hpp>
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/utils/eh/expected.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <system_error>
+#include <vector>
+
+using namespace xentara;
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief The number of inputs in the transaction
+	constexpr std::size_t kInputCount = 10000;
+	/// @brief The size of the encoded value of each input
+	constexpr std::size_t kValueSize = 2;
+	/// @brief The scaling of all the inputs
+	constexpr Scaling kScaling { ._factor = 0.1, ._offset = 0.0 };
+
+	/// @brief The type used to pass the payload or a read error
+	using PayloadOrError = utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>;
+
+	/// @brief An input that decodes and updates its own state, the way inputs were updated before the decode table existed
+	class VirtualInput
+	{
+	public:
+		virtual ~VirtualInput() = default;
+
+		/// @brief Decodes the value from the payload, and updates the state in the data block
+		virtual auto updateReadState(WriteSentinel &writeSentinel,
+			std::chrono::system_clock::time_point timeStamp,
+			const PayloadOrError &payloadOrError,
+			const CommonReadState::Changes &commonChanges,
+			PendingEventList &eventsToRaise) -> void = 0;
+	};
+
+	/// @brief An input with a big-endian 16-bit value
+	class Int16Input final : public VirtualInput
+	{
+	public:
+		explicit Int16Input(const PerValueReadState<double>::Descriptor &descriptor) : _descriptor(descriptor)
+		{
+		}
+
+		auto updateReadState(WriteSentinel &writeSentinel,
+			std::chrono::system_clock::time_point timeStamp,
+			const PayloadOrError &payloadOrError,
+			const CommonReadState::Changes &commonChanges,
+			PendingEventList &eventsToRaise) -> void final
+		{
+			// Decode the value, replacing errors with a default constructed value
+			const auto value = payloadOrError
+				? decodeValue<double, Encoding::Int16BigEndian>(
+					  payloadOrError->get().data().data() + _descriptor._payloadOffset, kScaling._factor, kScaling._offset)
+				: 0.0;
+
+			// Get the correct array entries
+			auto &state = writeSentinel[_descriptor._valueHandle];
+			const auto &oldState = writeSentinel.oldValues()[_descriptor._valueHandle];
+			auto &changeTime = writeSentinel[_descriptor._changeTimeHandle];
+			const auto &oldChangeTime = writeSentinel.oldValues()[_descriptor._changeTimeHandle];
+
+			// Set the value and detect changes
+			state._value = value;
+			const auto changed = state._value != oldState._value || commonChanges;
+
+			// Update the change time, if necessary
+			changeTime._changeTime = changed ? timeStamp : oldChangeTime._changeTime;
+
+			// Cause the correct events to be raised
+			if (changed)
+			{
+				eventsToRaise.push_back(*_descriptor._changedEvent);
+			}
+		}
+
+	private:
+		PerValueReadState<double>::Descriptor _descriptor;
+	};
+
+	/// @brief The states of the inputs of an I/O transaction, attached to a data block of their own
+	class Transaction final
+	{
+	public:
+		Transaction() : _states(kInputCount), _inputNumbers(kInputCount)
+		{
+			std::size_t eventCount = 0;
+			_commonState.attach(_dataArray, eventCount);
+			for (auto &&state : _states)
+			{
+				state.attach(_dataArray, eventCount, AttachPass::All);
+			}
+			_dataBlock.create(memory::memoryResources::data());
+			_eventsToRaise.reset(eventCount);
+
+			std::iota(_inputNumbers.begin(), _inputNumbers.end(), std::size_t(0));
+			_changedInputs.resize(changeMaskSize(kInputCount));
+		}
+
+		/// @brief Gets the descriptor of an input
+		auto descriptor(std::size_t inputNumber) noexcept -> PerValueReadState<double>::Descriptor
+		{
+			return _states[inputNumber].descriptor(inputNumber * kValueSize);
+		}
+
+		/// @brief Gets the committed value of an input
+		auto value(std::size_t inputNumber) const -> double
+		{
+			return _states[inputNumber].valueReadHandle(_dataBlock).read<double>().value_or(-1.0);
+		}
+
+		/// @brief Gets the committed change time of an input
+		auto changeTime(std::size_t inputNumber) const -> std::chrono::system_clock::time_point
+		{
+			const auto handle = _states[inputNumber].makeReadHandle(_dataBlock, model::Attribute::kChangeTime);
+			return handle->read<std::chrono::system_clock::time_point>().value_or(std::chrono::system_clock::time_point::max());
+		}
+
+		/// @brief Gets the number of times the changed event of an input was raised
+		auto changedEventCount(std::size_t inputNumber) -> std::size_t
+		{
+			std::size_t count = 0;
+			_states[inputNumber].forEachEvent([&](const process::Event::Role &, std::shared_ptr<process::Event> event)
+				{
+					count = event->raiseCount();
+					return true;
+				},
+				nullptr);
+			return count;
+		}
+
+		memory::Array _dataArray;
+		DataBlock _dataBlock { _dataArray };
+		CommonReadState _commonState;
+		std::vector<PerValueReadState<double>> _states;
+		PendingEventList _eventsToRaise;
+		std::vector<std::size_t> _inputNumbers;
+		std::vector<std::uint64_t> _changedInputs;
+	};
+
+	/// @brief Builds a payload of big-endian 16-bit values. Every tenth value depends on the variant.
+	auto makePayload(unsigned variant) -> std::vector<std::byte>
+	{
+		std::vector<std::byte> payload(kInputCount * kValueSize);
+		for (std::size_t index = 0; index < payload.size(); ++index)
+		{
+			payload[index] = std::byte(index * 7 & 0xff);
+		}
+		for (std::size_t input = 0; input < kInputCount; input += 10)
+		{
+			payload[input * kValueSize + 1] = std::byte(variant);
+		}
+		return payload;
+	}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	const auto iterations = iterationCount(argc, argv, 2000);
+
+	// Alternate between two payloads, so that every tenth input changes on each read
+	const std::array payloadData { makePayload(1), makePayload(2) };
+	const std::array payloads { ReadCommand::Payload(0, payloadData[0]), ReadCommand::Payload(0, payloadData[1]) };
+	const auto startTime = std::chrono::system_clock::now();
+
+	// One object per input, updated using a virtual call each
+	Transaction virtualTransaction;
+	std::vector<std::unique_ptr<VirtualInput>> inputs;
+	for (std::size_t index = 0; index < kInputCount; ++index)
+	{
+		inputs.push_back(std::make_unique<Int16Input>(virtualTransaction.descriptor(index)));
+	}
+
+	std::size_t virtualIteration = 0;
+	measure("virtual call per input", iterations, [&]
+		{
+			const auto timeStamp = startTime + std::chrono::microseconds(virtualIteration);
+			const PayloadOrError payloadOrError(std::cref(payloads[virtualIteration++ % payloads.size()]));
+
+			auto &transaction = virtualTransaction;
+			transaction._eventsToRaise.clear();
+			memory::WriteSentinel sentinel { transaction._dataBlock };
+			const auto commonChanges = transaction._commonState.update(sentinel, timeStamp, {}, transaction._eventsToRaise);
+			for (auto &&input : inputs)
+			{
+				input->updateReadState(sentinel, timeStamp, payloadOrError, commonChanges, transaction._eventsToRaise);
+			}
+			sentinel.commit(timeStamp, transaction._eventsToRaise);
+			doNotOptimize(transaction._eventsToRaise.size());
+		});
+
+	// The decode table, which decodes the values as a single run, and only visits the values that changed
+	Transaction tableTransaction;
+	DecodeTable table;
+	table.setInputNumbers(tableTransaction._inputNumbers);
+	for (std::size_t index = 0; index < kInputCount; ++index)
+	{
+		table.add<double>(tableTransaction.descriptor(index), Encoding::Int16BigEndian, kScaling);
+	}
+
+	std::size_t tableIteration = 0;
+	measure("decode table", iterations, [&]
+		{
+			const auto timeStamp = startTime + std::chrono::microseconds(tableIteration);
+			const PayloadOrError payloadOrError(std::cref(payloads[tableIteration++ % payloads.size()]));
+
+			// Decoding happens before the data block is opened, just like in the I/O transaction
+			auto &transaction = tableTransaction;
+			table.decode(payloadOrError);
+
+			transaction._eventsToRaise.clear();
+			memory::WriteSentinel sentinel { transaction._dataBlock };
+			const auto commonChanges = transaction._commonState.update(sentinel, timeStamp, {}, transaction._eventsToRaise);
+			std::ranges::fill(transaction._changedInputs, 0);
+			table.update(sentinel, timeStamp, commonChanges, transaction._changedInputs, true, transaction._eventsToRaise);
+			sentinel.commit(timeStamp, transaction._eventsToRaise);
+			doNotOptimize(transaction._eventsToRaise.size());
+		});
+
+	// Make sure both approaches have the same result
+	for (std::size_t index = 0; index < kInputCount; ++index)
+	{
+		check(virtualTransaction.value(index) == tableTransaction.value(index), "both approaches commit the same value");
+		check(virtualTransaction.changeTime(index) == tableTransaction.changeTime(index), "both approaches commit the same change time");
+		check(virtualTransaction.changedEventCount(index) == tableTransaction.changedEventCount(index),
+			"both approaches raise the same changed events");
+	}
+
+	return exitCode();
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+// Copyright (c) embedded ocean GmbH
+#include "Benchmark.hpp"
+#include "Check.hpp"
+
+#include "CustomError.hpp"
+#include "IoHandle.hpp"
+#include "ReadCommand.hpp"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <system_error>
+
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief The number of bytes each read asks for
+	constexpr std::size_t kReadSize = 64;
+
+	/// @brief Opens a handle for a device that always delivers data
+	auto openOnline(IoHandle &handle) -> void
+	{
+		const auto fileDescriptor = ::open("/dev/zero", O_RDONLY | O_CLOEXEC);
+		if (fileDescriptor < 0)
+		{
+			throw std::system_error(errno, std::system_category(), "could not open /dev/zero");
+		}
+		handle.open(fileDescriptor, 4);
+	}
+
+	/// @brief Opens a handle for a device that is offline, i.e. never delivers any data
+	auto openOffline(IoHandle &handle) -> void
+	{
+		std::array<int, 2> fileDescriptors {};
+		if (::pipe2(fileDescriptors.data(), O_CLOEXEC) != 0)
+		{
+			throw std::system_error(errno, std::system_category(), "could not create pipe");
+		}
+		// Closing the write end makes every read return end-of-file right away
+		::close(fileDescriptors[1]);
+		handle.open(fileDescriptors[0], 4);
+	}
+
+	/// @brief A read command with its own receive buffers
+	class TestCommand final
+	{
+	public:
+		explicit TestCommand(std::size_t size) : _command(0, size), _buffers(std::make_unique<std::byte[]>(size * 2))
+		{
+			_command.assignReceiveBuffers({ _buffers.get(), size }, { _buffers.get() + size, size });
+		}
+
+		auto operator*() noexcept -> ReadCommand &
+		{
+			return _command;
+		}
+
+	private:
+		ReadCommand _command;
+		std::unique_ptr<std::byte[]> _buffers;
+	};
+
+	/// @brief Reads the way the I/O component did before errors were returned: by throwing an exception on failure
+	auto throwingRead(const IoHandle &handle, ReadCommand &command) -> const ReadCommand::Payload &
+	{
+		auto result = handle.read(command);
+		if (!result)
+		{
+			throw std::system_error(result.error(), "could not read from the I/O component");
+		}
+		return *result;
+	}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	const auto iterations = iterationCount(argc, argv, 200000);
+
+	TestCommand command(kReadSize);
+
+	// The baseline: a device that is online, with the error returned as part of the result
+	{
+		IoHandle handle;
+		openOnline(handle);
+
+		std::size_t failures = 0;
+		measure("online, expected", iterations, [&]
+			{
+				const auto result = handle.read(*command);
+				failures += !result;
+				doNotOptimize(result);
+			});
+		check(failures == 0, "reads from an online device succeed");
+
+		handle.close();
+	}
+
+	// An offline device, with the error returned as part of the result
+	double expectedTime = 0;
+	{
+		IoHandle handle;
+		openOffline(handle);
+
+		std::size_t failures = 0;
+		std::error_code lastError;
+		expectedTime = measure("offline, expected", iterations, [&]
+			{
+				const auto result = handle.read(*command);
+				if (!result)
+				{
+					++failures;
+					lastError = result.error();
+				}
+				doNotOptimize(lastError);
+			});
+		check(failures == iterations, "every read from an offline device fails");
+		check(iterations == 0 || lastError == CustomError::IncompleteData, "the offline error is returned");
+
+		handle.close();
+	}
+
+	// An offline device, with the error thrown and recovered from the exception, the way the reads worked before
+	double exceptionTime = 0;
+	{
+		IoHandle handle;
+		openOffline(handle);
+
+		std::size_t failures = 0;
+		std::error_code lastError;
+		exceptionTime = measure("offline, exception", iterations, [&]
+			{
+				try
+				{
+					doNotOptimize(throwingRead(handle, *command));
+				}
+				catch (const std::system_error &exception)
+				{
+					++failures;
+					lastError = exception.code();
+				}
+				doNotOptimize(lastError);
+			});
+		check(failures == iterations, "every read from an offline device throws");
+		check(iterations == 0 || lastError == CustomError::IncompleteData, "the offline error is recovered from the exception");
+
+		handle.close();
+	}
+
+	if (expectedTime > 0)
+	{
+		std::printf("%-40s %12.2fx\n", "exception / expected (offline)", exceptionTime / expectedTime);
+	}
+
+	return exitCode();
+}
+
+#else
+
+auto main() -> int
+{
+	// The handle has no implementation to measure on other platforms
+	return 0;
+}
+
+#endif
\ No newline at end of file
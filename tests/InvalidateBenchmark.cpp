@@ -0,0 +1,224 @@
+// Copyright (c) embedded ocean GmbH
+#include "Benchmark.hpp"
+#include "Check.hpp"
+
+#include "Attributes.hpp"
+#include "ChangedInputSet.hpp"
+#include "CommonReadState.hpp"
+#include "CustomError.hpp"
+#include "DecodeTable.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+#include "Types.hpp"
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/ArrayBlock.hpp>
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+#include <xentara/utils/eh/expected.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <system_error>
+#include <vector>
+
+using namespace xentara;
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief The number of inputs in the transaction
+	constexpr std::size_t kInputCount = 200000;
+	/// @brief The size of the encoded value of each input
+	constexpr std::size_t kValueSize = 2;
+
+	/// @brief The type used to pass the payload or a read error
+	using PayloadOrError = utils::eh::expected<std::reference_wrapper<const ReadCommand::Payload>, std::error_code>;
+
+	/// @brief The read state of an I/O transaction, updated the same way TemplateIoTransaction does it
+	class Transaction final
+	{
+	public:
+		Transaction() : _states(kInputCount), _inputNumbers(kInputCount)
+		{
+			std::size_t eventCount = 0;
+			_commonState.attach(_dataArray, eventCount);
+			_changedInputs.attach(_dataArray, eventCount, kInputCount);
+			for (auto &&state : _states)
+			{
+				state.attach(_dataArray, eventCount, AttachPass::All);
+			}
+			_dataBlock.create(memory::memoryResources::data());
+			_eventsToRaise.reset(eventCount);
+
+			std::iota(_inputNumbers.begin(), _inputNumbers.end(), std::size_t(0));
+			_decodeTable.setInputNumbers(_inputNumbers);
+			for (std::size_t index = 0; index < kInputCount; ++index)
+			{
+				_decodeTable.add<double>(_states[index].descriptor(index * kValueSize), Encoding::Int16BigEndian, Scaling {});
+			}
+		}
+
+		/// @brief Updates the inputs with valid data, like TemplateIoTransaction::updateInputs()
+		auto read(const ReadCommand::Payload &payload, std::chrono::system_clock::time_point timeStamp) -> void
+		{
+			update(std::cref(payload), timeStamp, {});
+		}
+
+		/// @brief Invalidates the inputs the way it was done before: by decoding an error and updating the inputs as usual
+		auto invalidateUsingUpdate(std::chrono::system_clock::time_point timeStamp) -> void
+		{
+			update(utils::eh::unexpected(make_error_code(CustomError::NoData)), timeStamp, CustomError::NoData);
+		}
+
+		/// @brief Invalidates the inputs in a single sweep, like TemplateIoTransaction::invalidateData()
+		auto invalidate(std::chrono::system_clock::time_point timeStamp) -> void
+		{
+			_eventsToRaise.clear();
+			memory::WriteSentinel sentinel { _dataBlock };
+
+			_commonState.update(sentinel, timeStamp, CustomError::NoData, _eventsToRaise);
+			_decodeTable.invalidate(sentinel, timeStamp, true, _eventsToRaise);
+			_changedInputs.reset();
+			_changedInputs.markAll();
+			_changedInputs.update(sentinel, _eventsToRaise);
+
+			sentinel.commit(timeStamp, _eventsToRaise);
+		}
+
+		/// @brief Gets the committed value of an input
+		auto value(std::size_t inputNumber) const -> double
+		{
+			return _states[inputNumber].valueReadHandle(_dataBlock).read<double>().value_or(-1.0);
+		}
+
+		/// @brief Gets the committed change time of an input
+		auto changeTime(std::size_t inputNumber) const -> std::chrono::system_clock::time_point
+		{
+			const auto handle = _states[inputNumber].makeReadHandle(_dataBlock, model::Attribute::kChangeTime);
+			return handle->read<std::chrono::system_clock::time_point>().value_or(std::chrono::system_clock::time_point::max());
+		}
+
+		/// @brief Gets the committed number of changed inputs
+		auto changedInputCount() const -> std::uint64_t
+		{
+			const auto handle = _changedInputs.makeReadHandle(_dataBlock, attributes::kChangedInputCount);
+			return handle->read<std::uint64_t>().value_or(0);
+		}
+
+		/// @brief Gets the committed error
+		auto error() const -> std::error_code
+		{
+			const auto handle = _commonState.makeReadHandle(_dataBlock, attributes::kError);
+			return handle->read<std::error_code>().value_or(std::error_code());
+		}
+
+		/// @brief Gets the number of times the changed event of an input was raised
+		auto changedEventCount(std::size_t inputNumber) -> std::size_t
+		{
+			std::size_t count = 0;
+			_states[inputNumber].forEachEvent([&](const process::Event::Role &, std::shared_ptr<process::Event> event)
+				{
+					count = event->raiseCount();
+					return true;
+				},
+				nullptr);
+			return count;
+		}
+
+		/// @brief Gets the number of events collected during the last update
+		auto eventCount() const noexcept -> std::size_t
+		{
+			return _eventsToRaise.size();
+		}
+
+	private:
+		/// @brief Decodes the payload or error, and updates the inputs
+		auto update(const PayloadOrError &payloadOrError, std::chrono::system_clock::time_point timeStamp, std::error_code error) -> void
+		{
+			_decodeTable.decode(payloadOrError);
+
+			_eventsToRaise.clear();
+			memory::WriteSentinel sentinel { _dataBlock };
+
+			const auto commonChanges = _commonState.update(sentinel, timeStamp, error, _eventsToRaise);
+			const auto changedInputs = _changedInputs.reset();
+			_decodeTable.update(sentinel, timeStamp, commonChanges, changedInputs, true, _eventsToRaise);
+			_changedInputs.update(sentinel, _eventsToRaise);
+
+			sentinel.commit(timeStamp, _eventsToRaise);
+		}
+
+		memory::Array _dataArray;
+		DataBlock _dataBlock { _dataArray };
+		CommonReadState _commonState;
+		ChangedInputSet _changedInputs;
+		std::vector<PerValueReadState<double>> _states;
+		PendingEventList _eventsToRaise;
+		std::vector<std::size_t> _inputNumbers;
+		DecodeTable _decodeTable;
+	};
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	const auto iterations = iterationCount(argc, argv, 50);
+
+	// A payload whose values are all nonzero, so that invalidating changes all of them
+	std::vector<std::byte> payloadData(kInputCount * kValueSize);
+	for (std::size_t index = 0; index < kInputCount; ++index)
+	{
+		payloadData[index * kValueSize + 1] = std::byte(index % 255 + 1);
+	}
+	const ReadCommand::Payload payload(0, payloadData);
+	const auto startTime = std::chrono::system_clock::now();
+
+	// Valid data is read before each invalidation, so that every invalidation has something to invalidate. Only the
+	// invalidation itself is measured.
+	Transaction updateTransaction;
+	std::size_t updateIteration = 0;
+	measure("invalidate using update", iterations,
+		[&] { updateTransaction.read(payload, startTime + std::chrono::microseconds(2 * updateIteration)); },
+		[&]
+		{
+			updateTransaction.invalidateUsingUpdate(startTime + std::chrono::microseconds(2 * updateIteration++ + 1));
+			doNotOptimize(updateTransaction.eventCount());
+		});
+
+	Transaction sweepTransaction;
+	std::size_t sweepIteration = 0;
+	measure("invalidate in one sweep", iterations,
+		[&] { sweepTransaction.read(payload, startTime + std::chrono::microseconds(2 * sweepIteration)); },
+		[&]
+		{
+			sweepTransaction.invalidate(startTime + std::chrono::microseconds(2 * sweepIteration++ + 1));
+			doNotOptimize(sweepTransaction.eventCount());
+		});
+
+	// Make sure both approaches have the same result
+	if (iterations > 0)
+	{
+		check(updateTransaction.error() == CustomError::NoData, "invalidating using update sets the error");
+		check(sweepTransaction.error() == CustomError::NoData, "invalidating in one sweep sets the error");
+		check(updateTransaction.changedInputCount() == kInputCount, "invalidating using update marks all inputs as changed");
+		check(sweepTransaction.changedInputCount() == kInputCount, "invalidating in one sweep marks all inputs as changed");
+		check(updateTransaction.eventCount() == sweepTransaction.eventCount(), "both approaches raise the same number of events");
+		for (std::size_t index = 0; index < kInputCount; ++index)
+		{
+			check(updateTransaction.value(index) == sweepTransaction.value(index), "both approaches commit the same value");
+			check(updateTransaction.changeTime(index) == sweepTransaction.changeTime(index), "both approaches commit the same change time");
+			check(updateTransaction.changedEventCount(index) == sweepTransaction.changedEventCount(index),
+				"both approaches raise the same changed events");
+		}
+	}
+
+	return exitCode();
+}
\ No newline at end of file
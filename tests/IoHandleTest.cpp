@@ -0,0 +1,255 @@
+// Copyright (c) embedded ocean GmbH
+#include "Check.hpp"
+
+#include "CustomError.hpp"
+#include "IoHandle.hpp"
+#include "ReadCommand.hpp"
+
+#if defined(__linux__)
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief A pipe that stands in for the I/O component
+	///
+	/// The handle reads from the read end of the pipe, and the test plays the I/O component by writing to the write end.
+	class PipeStandIn final
+	{
+	public:
+		PipeStandIn(unsigned queueDepth, std::chrono::nanoseconds timeout = IoHandle::kDefaultTimeout)
+		{
+			std::array<int, 2> fileDescriptors {};
+			if (::pipe(fileDescriptors.data()) != 0)
+			{
+				throw std::system_error(errno, std::system_category(), "could not create pipe");
+			}
+			_writeEnd = fileDescriptors[1];
+			_handle.open(fileDescriptors[0], queueDepth, timeout);
+		}
+
+		~PipeStandIn()
+		{
+			_handle.close();
+			closeWriteEnd();
+		}
+
+		auto handle() noexcept -> IoHandle &
+		{
+			return _handle;
+		}
+
+		/// @brief Sends data to the handle
+		auto send(std::span<const std::byte> data) -> void
+		{
+			check(::write(_writeEnd, data.data(), data.size()) == ssize_t(data.size()), "data can be written to the pipe");
+		}
+
+		/// @brief Closes the write end, so that reads return no data
+		auto closeWriteEnd() noexcept -> void
+		{
+			if (_writeEnd >= 0)
+			{
+				::close(_writeEnd);
+				_writeEnd = -1;
+			}
+		}
+
+	private:
+		IoHandle _handle;
+		int _writeEnd { -1 };
+	};
+
+	/// @brief A read command with its own receive buffers
+	class TestCommand final
+	{
+	public:
+		explicit TestCommand(std::size_t size) : _command(0, size), _buffers(std::make_unique<std::byte[]>(size * 2))
+		{
+			_command.assignReceiveBuffers({ _buffers.get(), size }, { _buffers.get() + size, size });
+		}
+
+		auto operator*() noexcept -> ReadCommand &
+		{
+			return _command;
+		}
+
+	private:
+		ReadCommand _command;
+		std::unique_ptr<std::byte[]> _buffers;
+	};
+
+	/// @brief Makes some data to send
+	auto makeData(std::size_t size, std::uint8_t first) -> std::vector<std::byte>
+	{
+		std::vector<std::byte> data(size);
+		for (std::size_t index = 0; index < size; ++index)
+		{
+			data[index] = std::byte(first + index);
+		}
+		return data;
+	}
+
+	/// @brief Checks that a payload contains the expected data
+	auto hasData(const ReadCommand::Payload &payload, std::span<const std::byte> data) -> bool
+	{
+		return std::ranges::equal(payload.data(), data);
+	}
+
+	/// @brief Checks a simple read
+	auto checkRead() -> void
+	{
+		PipeStandIn standIn(4);
+		TestCommand command(4);
+
+		const auto data = makeData(4, 1);
+		standIn.send(data);
+		const auto result = standIn.handle().read(*command);
+		check(result && hasData(*result, data), "a read receives the data sent");
+	}
+
+	/// @brief Checks that replies can be received in a different order than the commands were sent
+	auto checkOutOfOrderReceive() -> void
+	{
+		PipeStandIn standIn(4);
+		TestCommand first(4);
+		TestCommand second(4);
+
+		check(bool(standIn.handle().sendRead(*first)), "the first read can be sent");
+		check(bool(standIn.handle().sendRead(*second)), "the second read can be sent");
+		standIn.send(makeData(8, 1));
+
+		// Receiving the second reply first stashes the first one
+		check(bool(standIn.handle().receiveRead(*second)), "the second reply can be received first");
+		check(bool(standIn.handle().receiveRead(*first)), "the first reply is taken from the stash");
+	}
+
+	/// @brief Checks that a cancelled read does not deliver a stale reply to the next read of the same command
+	auto checkCancel() -> void
+	{
+		PipeStandIn standIn(4);
+		TestCommand command(4);
+
+		// Send a read that will never be answered, and cancel it
+		check(bool(standIn.handle().sendRead(*command)), "the read can be sent");
+		standIn.handle().cancelRead(*command);
+
+		// The next read must receive fresh data
+		const auto data = makeData(4, 42);
+		standIn.send(data);
+		const auto result = standIn.handle().read(*command);
+		check(result && hasData(*result, data), "the read after a cancelled read receives fresh data");
+	}
+
+	/// @brief Checks that the number of outstanding reads is limited, so that the stash cannot grow
+	auto checkLimit() -> void
+	{
+		constexpr unsigned kQueueDepth = 2;
+		PipeStandIn standIn(kQueueDepth);
+
+		// The handle allows twice the queue depth to be outstanding
+		std::vector<std::unique_ptr<TestCommand>> commands;
+		for (unsigned index = 0; index < kQueueDepth * 2; ++index)
+		{
+			auto &command = *commands.emplace_back(std::make_unique<TestCommand>(1));
+			check(bool(standIn.handle().sendRead(*command)), "reads up to the limit can be sent");
+		}
+
+		TestCommand excess(1);
+		const auto result = standIn.handle().sendRead(*excess);
+		check(!result && result.error() == std::errc::resource_unavailable_try_again, "reads beyond the limit are refused");
+
+		// Cancelling a read makes room for another one
+		standIn.handle().cancelRead(**commands.back());
+		check(bool(standIn.handle().sendRead(*excess)), "a read can be sent after another one was cancelled");
+	}
+
+	/// @brief Checks that missing data is reported as an error
+	auto checkIncompleteData() -> void
+	{
+		PipeStandIn standIn(4);
+		TestCommand command(4);
+
+		standIn.send(makeData(2, 1));
+		standIn.closeWriteEnd();
+		const auto result = standIn.handle().read(*command);
+		check(!result && result.error() == CustomError::IncompleteData, "a short read is reported as incomplete data");
+	}
+
+	/// @brief Checks that a read the I/O component never answers times out, and is cancelled
+	auto checkTimeout() -> void
+	{
+		PipeStandIn standIn(4, std::chrono::milliseconds(50));
+		TestCommand command(4);
+
+		const auto timedOut = standIn.handle().read(*command);
+		check(!timedOut && timedOut.error() == std::errc::timed_out, "a read without an answer times out");
+
+		// The timed out read must have been cancelled, so the next read receives the data
+		const auto data = makeData(4, 7);
+		standIn.send(data);
+		const auto result = standIn.handle().read(*command);
+		check(result && hasData(*result, data), "the read after a timed out read receives the data");
+	}
+
+	/// @brief Checks that a thread waiting for a reply does not keep other threads from sending commands
+	auto checkConcurrentWait() -> void
+	{
+		PipeStandIn standIn(4);
+		TestCommand first(4);
+		TestCommand second(4);
+
+		check(bool(standIn.handle().sendRead(*first)), "the first read can be sent");
+		bool firstReceived = false;
+		{
+			std::jthread waiter([&] { firstReceived = bool(standIn.handle().receiveRead(*first)); });
+
+			// Give the waiter time to block on the ring. Sending the second read must not wait for it.
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			check(bool(standIn.handle().sendRead(*second)), "a read can be sent while another thread waits");
+
+			standIn.send(makeData(8, 1));
+			check(bool(standIn.handle().receiveRead(*second)), "the read sent while waiting is received");
+		}
+		check(firstReceived, "the waiting thread receives its reply");
+	}
+
+} // namespace
+
+auto main() -> int
+{
+	checkRead();
+	checkOutOfOrderReceive();
+	checkCancel();
+	checkLimit();
+	checkIncompleteData();
+	checkTimeout();
+	checkConcurrentWait();
+
+	return exitCode();
+}
+
+#else
+
+auto main() -> int
+{
+	// The handle has no implementation to test on other platforms
+	return 0;
+}
+
+#endif
\ No newline at end of file
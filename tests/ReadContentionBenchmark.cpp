@@ -0,0 +1,176 @@
+// Copyright (c) embedded ocean GmbH
+#include "Benchmark.hpp"
+#include "Check.hpp"
+
+#include "InputSnapshot.hpp"
+#include "VersionedBuffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief The number of inputs in the transaction
+	constexpr std::size_t kInputCount = 1000;
+
+	/// @brief The writer's latency for committing a new version of the inputs
+	struct Latency
+	{
+		/// @brief The mean latency, in nanoseconds
+		double _mean { 0 };
+		/// @brief The maximum latency, in nanoseconds
+		double _max { 0 };
+	};
+
+	/// @brief Fills the cells of all the inputs with a number
+	auto fill(std::span<std::byte> cells, std::uint64_t number) -> void
+	{
+		for (std::size_t input = 0; input < kInputCount; ++input)
+		{
+			std::memcpy(cells.data() + input * InputSnapshot::kCellSize, &number, sizeof(number));
+		}
+	}
+
+	/// @brief Checks whether all the cells hold the same number
+	auto isConsistent(std::span<const std::byte> cells) -> bool
+	{
+		std::uint64_t first;
+		std::memcpy(&first, cells.data(), sizeof(first));
+		for (std::size_t input = 1; input < kInputCount; ++input)
+		{
+			std::uint64_t number;
+			std::memcpy(&number, cells.data() + input * InputSnapshot::kCellSize, sizeof(number));
+			if (number != first)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// @brief Runs reader threads that read the inputs continuously, and measures the writer's latency
+	/// @param readerCount The number of reader threads
+	/// @param iterations The number of versions the writer commits
+	/// @param read Reads the inputs once, and returns whether they were consistent
+	/// @param write Commits a new version of the inputs
+	template <typename Read, typename Write>
+	auto run(std::size_t readerCount, std::size_t iterations, Read &&read, Write &&write) -> Latency
+	{
+		std::atomic<bool> done { false };
+		std::atomic<std::size_t> inconsistentCount { 0 };
+
+		// Start the readers
+		std::vector<std::jthread> readers;
+		for (std::size_t index = 0; index < readerCount; ++index)
+		{
+			readers.emplace_back([&]
+				{
+					while (!done.load(std::memory_order_relaxed))
+					{
+						if (!read())
+						{
+							++inconsistentCount;
+						}
+
+						// Real consumers read periodically rather than in a tight loop. Pausing also keeps a reader-preferring
+						// lock from starving the writer completely, which would stall the benchmark.
+						std::this_thread::sleep_for(std::chrono::microseconds(1));
+					}
+				});
+		}
+
+		// Commit the versions, spaced out a little like a cyclic read task would
+		Latency latency;
+		for (std::size_t iteration = 1; iteration <= iterations; ++iteration)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			write(std::uint64_t(iteration));
+			const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+			latency._mean += elapsed;
+			latency._max = std::max(latency._max, elapsed);
+
+			std::this_thread::sleep_for(std::chrono::microseconds(20));
+		}
+		latency._mean /= double(std::max<std::size_t>(iterations, 1));
+
+		done = true;
+		readers.clear();
+
+		check(inconsistentCount == 0, "readers never see a partially committed version");
+		return latency;
+	}
+
+	/// @brief Prints the latency of a run
+	auto print(const char *name, std::size_t readerCount, const Latency &latency) -> void
+	{
+		std::printf("%-20s %3zu readers: %12.1f ns mean commit, %12.1f ns max commit\n", name, readerCount, latency._mean, latency._max);
+	}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	const auto iterations = iterationCount(argc, argv, 5000);
+
+	for (const std::size_t readerCount : { 0, 1, 4, 16 })
+	{
+		// A single block protected by a reader/writer lock, where the commit has to wait for all the readers to leave
+		{
+			std::vector<std::byte> block(kInputCount * InputSnapshot::kCellSize);
+			std::shared_mutex mutex;
+
+			const auto latency = run(readerCount, iterations,
+				[&]
+				{
+					std::shared_lock lock(mutex);
+					return isConsistent(block);
+				},
+				[&](std::uint64_t number)
+				{
+					std::unique_lock lock(mutex);
+					fill(block, number);
+				});
+			print("locked block", readerCount, latency);
+		}
+
+		// Versioned inputs, where the readers pin a version and the commit writes a different one
+		{
+			VersionedBuffer buffer;
+			buffer.reset(InputSnapshot::size(kInputCount));
+
+			const auto latency = run(readerCount, iterations,
+				[&]
+				{
+					const auto reader = buffer.read();
+					return isConsistent(reader.data().subspan(InputSnapshot::size(0)));
+				},
+				[&](std::uint64_t number)
+				{
+					if (const auto data = buffer.beginWrite(); !data.empty())
+					{
+						fill(InputSnapshot::cells(data), number);
+						buffer.publish();
+					}
+				});
+			print("versioned", readerCount, latency);
+			std::printf("%-20s %3zu readers: %12llu versions skipped\n", "", readerCount, (unsigned long long)buffer.skippedCount());
+		}
+	}
+
+	return exitCode();
+}
\ No newline at end of file
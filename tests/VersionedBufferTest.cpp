@@ -0,0 +1,186 @@
+// Copyright (c) embedded ocean GmbH
+#include "Check.hpp"
+
+#include "InputSnapshot.hpp"
+#include "VersionedBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief Fills the data of a version with a number
+	auto fill(std::span<std::byte> data, std::uint64_t number) -> void
+	{
+		for (std::size_t offset = 0; offset + sizeof(number) <= data.size(); offset += sizeof(number))
+		{
+			std::memcpy(data.data() + offset, &number, sizeof(number));
+		}
+	}
+
+	/// @brief Gets the number a version was filled with, or std::nullopt if the version is torn
+	auto number(std::span<const std::byte> data) -> std::optional<std::uint64_t>
+	{
+		std::uint64_t first;
+		std::memcpy(&first, data.data(), sizeof(first));
+		for (std::size_t offset = sizeof(first); offset + sizeof(first) <= data.size(); offset += sizeof(first))
+		{
+			std::uint64_t number;
+			std::memcpy(&number, data.data() + offset, sizeof(number));
+			if (number != first)
+			{
+				return std::nullopt;
+			}
+		}
+		return first;
+	}
+
+	/// @brief Checks that readers keep the version they pinned, and that new readers see the latest version
+	auto checkVersions() -> void
+	{
+		VersionedBuffer buffer;
+		buffer.reset(100);
+
+		// The initial version is all zeros
+		check(number(buffer.read().data()) == 0, "the initial version is zero");
+
+		const auto first = buffer.read();
+
+		auto data = buffer.beginWrite();
+		check(data.size() == 100, "a new version has the size of the data");
+		fill(data, 1);
+		buffer.publish();
+
+		check(number(first.data()) == 0, "a pinned version is not overwritten");
+		check(number(buffer.read().data()) == 1, "new readers see the published version");
+	}
+
+	/// @brief Checks that the writer skips versions instead of waiting if readers pin all the slots
+	auto checkPinnedSlots() -> void
+	{
+		VersionedBuffer buffer;
+		buffer.reset(64, 2);
+
+		// Pin the initial version, and publish a second one
+		std::optional pinned(buffer.read());
+		auto data = buffer.beginWrite();
+		fill(data, 1);
+		buffer.publish();
+
+		// The only other slot is still pinned
+		check(buffer.beginWrite().empty(), "no version can be written while readers pin all the other slots");
+		check(buffer.skippedCount() == 1, "the skipped version is counted");
+		check(number(buffer.read().data()) == 1, "readers keep seeing the current version");
+
+		// Releasing the pinned version frees its slot
+		pinned.reset();
+		data = buffer.beginWrite();
+		check(!data.empty(), "a released slot can be reused");
+		check(number(data) == 1, "a new version starts with the data of the current one");
+		fill(data, 2);
+		buffer.publish();
+		check(number(buffer.read().data()) == 2, "the version written into the released slot is published");
+	}
+
+	/// @brief Checks that readers never see torn versions, while a writer publishes new versions as fast as it can
+	auto checkConcurrentReaders() -> void
+	{
+		VersionedBuffer buffer;
+		buffer.reset(1024);
+
+		constexpr std::uint64_t kVersionCount = 20000;
+		std::atomic<bool> done { false };
+		std::atomic<std::size_t> tornCount { 0 };
+		std::atomic<std::size_t> regressionCount { 0 };
+
+		std::vector<std::jthread> readers;
+		for (std::size_t index = 0; index < 4; ++index)
+		{
+			readers.emplace_back([&]
+				{
+					std::uint64_t last = 0;
+					while (!done.load(std::memory_order_relaxed))
+					{
+						const auto current = number(buffer.read().data());
+						if (!current)
+						{
+							++tornCount;
+						}
+						else if (*current < last)
+						{
+							++regressionCount;
+						}
+						else
+						{
+							last = *current;
+						}
+					}
+				});
+		}
+
+		for (std::uint64_t version = 1; version <= kVersionCount; ++version)
+		{
+			if (const auto data = buffer.beginWrite(); !data.empty())
+			{
+				fill(data, version);
+				buffer.publish();
+			}
+		}
+		done = true;
+		readers.clear();
+
+		check(tornCount == 0, "readers never see a partially written version");
+		check(regressionCount == 0, "readers never see an older version after a newer one");
+	}
+
+	/// @brief Checks that a snapshot returns the header and the values that were written
+	auto checkInputSnapshot() -> void
+	{
+		VersionedBuffer buffer;
+		buffer.reset(InputSnapshot::size(3));
+
+		const auto updateTime = std::chrono::system_clock::now();
+		const auto error = std::make_error_code(std::errc::timed_out);
+
+		const auto data = buffer.beginWrite();
+		InputSnapshot::writeHeader(data, updateTime, error);
+		const auto cells = InputSnapshot::cells(data);
+		const double value0 = 1.5;
+		const std::int16_t value1 = -7;
+		const bool value2 = true;
+		std::memcpy(cells.data() + 0 * InputSnapshot::kCellSize, &value0, sizeof(value0));
+		std::memcpy(cells.data() + 1 * InputSnapshot::kCellSize, &value1, sizeof(value1));
+		std::memcpy(cells.data() + 2 * InputSnapshot::kCellSize, &value2, sizeof(value2));
+		buffer.publish();
+
+		const InputSnapshot snapshot(buffer.read());
+		check(snapshot.updateTime() == updateTime, "the snapshot has the update time");
+		check(snapshot.error() == error, "the snapshot has the error");
+		check(snapshot.value<double>(0) == value0, "the snapshot has the double value");
+		check(snapshot.value<std::int16_t>(1) == value1, "the snapshot has the integer value");
+		check(snapshot.value<bool>(2) == value2, "the snapshot has the bool value");
+	}
+
+} // namespace
+
+auto main() -> int
+{
+	checkVersions();
+	checkPinnedSlots();
+	checkConcurrentReaders();
+	checkInputSnapshot();
+
+	return exitCode();
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+// Copyright (c) embedded ocean GmbH
+#include "Check.hpp"
+
+#include "WriteCommandBuilder.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief The size of each output used by the tests
+	constexpr std::size_t kOutputSize = 2;
+
+	/// @brief Adds outputs at the given addresses and compiles the builder
+	auto makeBuilder(std::initializer_list<std::uint64_t> addresses, std::size_t maxGap) -> WriteCommandBuilder
+	{
+		WriteCommandBuilder builder;
+		builder.setMaxGap(maxGap);
+		for (auto &&address : addresses)
+		{
+			builder.addOutput(address, kOutputSize);
+		}
+		builder.compile();
+		return builder;
+	}
+
+	/// @brief Stages an output and fills its data with a value
+	auto stage(WriteCommandBuilder &builder, std::size_t outputIndex, std::uint8_t value) -> void
+	{
+		std::ranges::fill(builder.stage(outputIndex), std::byte(value));
+	}
+
+	/// @brief Writes a single output successfully, so that its shadow value becomes valid
+	auto writeSuccessfully(WriteCommandBuilder &builder, std::size_t outputIndex, std::uint8_t value) -> void
+	{
+		stage(builder, outputIndex, value);
+		builder.build();
+		builder.finish(true);
+	}
+
+	/// @brief Checks that adjacent pending outputs are merged into a single frame
+	auto checkMerge() -> void
+	{
+		auto builder = makeBuilder({ 0, 2, 4 }, 0);
+
+		// Stage them out of order, to make sure the frames are built by address
+		stage(builder, 2, 3);
+		stage(builder, 0, 1);
+		stage(builder, 1, 2);
+		const auto frames = builder.build();
+		check(frames.size() == 1, "adjacent pending outputs are merged into one frame");
+		if (frames.size() == 1)
+		{
+			check(frames[0]._address == 0 && frames[0]._size == 3 * kOutputSize, "the frame covers all the outputs");
+			const std::vector<std::byte> expected { std::byte(1), std::byte(1), std::byte(2), std::byte(2), std::byte(3), std::byte(3) };
+			check(std::ranges::equal(builder.data(frames[0]), expected), "the frame contains the staged values in address order");
+		}
+		builder.finish(true);
+	}
+
+	/// @brief Checks that a gap is only bridged using shadow values that were written successfully
+	auto checkGapBridging() -> void
+	{
+		auto builder = makeBuilder({ 0, 2, 4 }, kOutputSize);
+
+		// The output in the middle was never written, so its shadow value cannot be used
+		stage(builder, 0, 1);
+		stage(builder, 2, 3);
+		check(builder.build().size() == 2, "a gap is not bridged using a value that was never written");
+		builder.finish(true);
+
+		// Once the output in the middle has been written, its shadow value bridges the gap
+		writeSuccessfully(builder, 1, 2);
+		stage(builder, 0, 4);
+		stage(builder, 2, 6);
+		const auto frames = builder.build();
+		check(frames.size() == 1, "a gap is bridged using a value that was written successfully");
+		if (frames.size() == 1)
+		{
+			const std::vector<std::byte> expected { std::byte(4), std::byte(4), std::byte(2), std::byte(2), std::byte(6), std::byte(6) };
+			check(std::ranges::equal(builder.data(frames[0]), expected), "the gap is filled with the value written last");
+		}
+		builder.finish(true);
+	}
+
+	/// @brief Checks that gaps that are too large, or that contain bytes not belonging to any output, are not bridged
+	auto checkGapLimits() -> void
+	{
+		// The gap is larger than allowed
+		{
+			auto builder = makeBuilder({ 0, 2, 4, 6 }, kOutputSize);
+			writeSuccessfully(builder, 1, 2);
+			writeSuccessfully(builder, 2, 3);
+			stage(builder, 0, 1);
+			stage(builder, 3, 4);
+			check(builder.build().size() == 2, "a gap larger than the maximum gap is not bridged");
+			builder.finish(true);
+		}
+
+		// The gap contains bytes that do not belong to any output
+		{
+			auto builder = makeBuilder({ 0, 4 }, 100);
+			stage(builder, 0, 1);
+			stage(builder, 1, 2);
+			check(builder.build().size() == 2, "bytes that do not belong to any output are never written");
+			builder.finish(true);
+		}
+	}
+
+	/// @brief Checks that a frame never exceeds the maximum command size
+	auto checkMaxCommandSize() -> void
+	{
+		auto builder = makeBuilder({ 0, 2, 4 }, 0);
+		builder.setMaxCommandSize(2 * kOutputSize);
+		stage(builder, 0, 1);
+		stage(builder, 1, 2);
+		stage(builder, 2, 3);
+		const auto frames = builder.build();
+		check(frames.size() == 2, "frames are split at the maximum command size");
+		check(std::ranges::all_of(frames, [](const auto &frame) { return frame._size <= 2 * kOutputSize; }),
+			"no frame exceeds the maximum command size");
+		builder.finish(true);
+	}
+
+	/// @brief Checks that the shadow values of a failed write are no longer used to bridge gaps
+	auto checkFailedWrite() -> void
+	{
+		auto builder = makeBuilder({ 0, 2, 4 }, kOutputSize);
+		writeSuccessfully(builder, 1, 2);
+
+		// Fail a write of the output in the middle
+		stage(builder, 1, 5);
+		builder.build();
+		builder.finish(false);
+
+		// Its shadow value no longer matches the I/O component, so it must not be used to bridge the gap
+		stage(builder, 0, 1);
+		stage(builder, 2, 3);
+		check(builder.build().size() == 2, "the value of a failed write is not used to bridge a gap");
+		builder.finish(true);
+
+		// After a successful write, it can be used again
+		writeSuccessfully(builder, 1, 2);
+		stage(builder, 0, 1);
+		stage(builder, 2, 3);
+		check(builder.build().size() == 1, "the value can be used again after it was written successfully");
+		builder.finish(true);
+	}
+
+	/// @brief Checks that the outputs are no longer pending after a write
+	auto checkFinishClearsPending() -> void
+	{
+		auto builder = makeBuilder({ 0, 2 }, 0);
+		stage(builder, 0, 1);
+		builder.build();
+		builder.finish(false);
+		check(builder.build().empty(), "no outputs are pending after a failed write");
+
+		stage(builder, 1, 2);
+		builder.build();
+		builder.finish(true);
+		check(builder.build().empty(), "no outputs are pending after a successful write");
+	}
+
+	/// @brief Checks that overlapping outputs are rejected
+	auto checkOverlap() -> void
+	{
+		WriteCommandBuilder builder;
+		builder.addOutput(4, kOutputSize);
+		builder.addOutput(0, 5);
+		bool thrown = false;
+		try
+		{
+			builder.compile();
+		}
+		catch (const std::runtime_error &)
+		{
+			thrown = true;
+		}
+		check(thrown, "overlapping outputs are rejected");
+	}
+
+} // namespace
+
+auto main() -> int
+{
+	checkMerge();
+	checkGapBridging();
+	checkGapLimits();
+	checkMaxCommandSize();
+	checkFailedWrite();
+	checkFinishClearsPending();
+	checkOverlap();
+
+	return exitCode();
+}
\ No newline at end of file
@@ -0,0 +1,357 @@
+// Copyright (c) embedded ocean GmbH
+#include "Benchmark.hpp"
+#include "Check.hpp"
+
+#include "ChangedInputSet.hpp"
+#include "CommonReadState.hpp"
+#include "DecodeTable.hpp"
+#include "Events.hpp"
+#include "PerValueReadState.hpp"
+#include "ReadCommand.hpp"
+#include "Types.hpp"
+#include "WriteState.hpp"
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/ArrayBlock.hpp>
+#include <xentara/memory/memoryResources.hpp>
+#include <xentara/memory/WriteSentinel.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <numeric>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace xentara;
+using namespace xentara::plugins::templateDriver;
+using namespace xentara::plugins::templateDriver::tests;
+
+namespace
+{
+
+	/// @brief The number of inputs in the transaction
+	constexpr std::size_t kInputCount = 1000;
+	/// @brief The number of outputs in the transaction
+	constexpr std::size_t kOutputCount = 100;
+	/// @brief The size of the encoded value of each input
+	constexpr std::size_t kValueSize = 2;
+
+	/// @brief Gets the number of times an event of a state was raised
+	template <typename State>
+	auto raiseCount(State &state, const process::Event::Role &role) -> std::size_t
+	{
+		std::size_t count = 0;
+		state.forEachEvent([&](const process::Event::Role &eventRole, std::shared_ptr<process::Event> event)
+			{
+				if (eventRole == role)
+				{
+					count = event->raiseCount();
+					return true;
+				}
+				return false;
+			},
+			nullptr);
+		return count;
+	}
+
+	/// @brief Reads an attribute of a state
+	template <typename Value, typename State>
+	auto read(const State &state, const DataBlock &dataBlock, const model::Attribute &attribute) -> Value
+	{
+		const auto handle = state.makeReadHandle(dataBlock, attribute);
+		return handle ? handle->template read<Value>().value_or(Value()) : Value();
+	}
+
+	/// @brief The read and write states of an I/O transaction, updated the same way TemplateIoTransaction does it
+	class Transaction final
+	{
+	public:
+		/// @brief Constructor
+		/// @param separateBlocks Whether the write states are kept in a block of their own, or in the read data block like before
+		explicit Transaction(bool separateBlocks) :
+			_separateBlocks(separateBlocks), _inputStates(kInputCount), _outputStates(kOutputCount), _inputNumbers(kInputCount)
+		{
+			// Attach the read states
+			std::size_t readEventCount = 0;
+			_readState.attach(_readDataArray, readEventCount);
+			_changedInputs.attach(_readDataArray, readEventCount, kInputCount);
+			for (auto &&state : _inputStates)
+			{
+				state.attach(_readDataArray, readEventCount, AttachPass::All);
+			}
+
+			// Attach the write states of the transaction and of the outputs
+			std::size_t writeEventCount = 0;
+			auto &writeDataArray = _separateBlocks ? _writeDataArray : _readDataArray;
+			_writeState.attach(writeDataArray, writeEventCount);
+			for (auto &&state : _outputStates)
+			{
+				state.attach(writeDataArray, writeEventCount);
+			}
+
+			// Create the data blocks
+			_readDataBlock.create(memory::memoryResources::data());
+			_writeDataBlock.create(memory::memoryResources::data());
+			_readEventsToRaise.reset(readEventCount);
+			_writeEventsToRaise.reset(writeEventCount);
+
+			// Set up the decode table
+			std::iota(_inputNumbers.begin(), _inputNumbers.end(), std::size_t(0));
+			_decodeTable.setInputNumbers(_inputNumbers);
+			for (std::size_t index = 0; index < kInputCount; ++index)
+			{
+				_decodeTable.add<double>(_inputStates[index].descriptor(index * kValueSize), Encoding::Int16BigEndian, Scaling {});
+			}
+		}
+
+		/// @brief Updates all the inputs after a read, like TemplateIoTransaction::updateInputs()
+		auto updateInputs(const ReadCommand::Payload &payload, std::chrono::system_clock::time_point timeStamp) -> void
+		{
+			_decodeTable.decode(std::cref(payload));
+
+			_readEventsToRaise.clear();
+			memory::WriteSentinel sentinel { _readDataBlock };
+
+			const auto commonChanges = _readState.update(sentinel, timeStamp, {}, _readEventsToRaise);
+			const auto changedInputs = _changedInputs.reset();
+			_decodeTable.update(sentinel, timeStamp, commonChanges, changedInputs, true, _readEventsToRaise);
+			_changedInputs.update(sentinel, _readEventsToRaise);
+
+			sentinel.commit(timeStamp, _readEventsToRaise);
+		}
+
+		/// @brief Updates the write states of all the outputs after a write, like TemplateIoTransaction::updateOutputs()
+		auto updateOutputs(std::chrono::system_clock::time_point timeStamp) -> void
+		{
+			_writeEventsToRaise.clear();
+			memory::WriteSentinel sentinel { writeDataBlock() };
+
+			_writeState.update(sentinel, timeStamp, {}, _writeEventsToRaise);
+			for (auto &&state : _outputStates)
+			{
+				state.update(sentinel, timeStamp, {}, _writeEventsToRaise);
+			}
+
+			sentinel.commit(timeStamp, _writeEventsToRaise);
+		}
+
+		/// @brief Gets the number of times the input updates had to wait for another commit
+		auto inputContention() const noexcept -> std::size_t
+		{
+			// If the blocks are shared, we cannot tell which commit had to wait
+			return _separateBlocks ? _readDataBlock.contendedCount() : 0;
+		}
+
+		/// @brief Gets the number of times the write state updates had to wait for another commit
+		auto outputContention() const noexcept -> std::size_t
+		{
+			return _separateBlocks ? _writeDataBlock.contendedCount() : 0;
+		}
+
+		/// @brief Gets the number of times any commit had to wait for another one
+		auto totalContention() const noexcept -> std::size_t
+		{
+			return _readDataBlock.contendedCount() + _writeDataBlock.contendedCount();
+		}
+
+		/// @brief Checks that the committed inputs hold the values of a payload
+		auto inputsMatch(const ReadCommand::Payload &payload) const -> bool
+		{
+			for (std::size_t index = 0; index < kInputCount; ++index)
+			{
+				const auto data = payload.data().subspan(index * kValueSize, kValueSize);
+				const auto expected = double(std::int16_t(std::uint16_t(data[0]) << 8 | std::uint16_t(data[1])));
+				if (_inputStates[index].valueReadHandle(_readDataBlock).read<double>() != expected)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Checks that every input raised its changed event a certain number of times
+		auto inputEventsRaised(std::size_t count) -> bool
+		{
+			for (auto &&state : _inputStates)
+			{
+				if (raiseCount(state, process::Event::kChanged) != count)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Gets the committed update time of the inputs
+		auto updateTime() const -> std::chrono::system_clock::time_point
+		{
+			return read<std::chrono::system_clock::time_point>(_readState, _readDataBlock, model::Attribute::kUpdateTime);
+		}
+
+		/// @brief Checks that all the write states hold a certain write time
+		auto writeTimesAre(std::chrono::system_clock::time_point timeStamp) const -> bool
+		{
+			const auto &block = writeDataBlock();
+			if (read<std::chrono::system_clock::time_point>(_writeState, block, model::Attribute::kWriteTime) != timeStamp)
+			{
+				return false;
+			}
+			for (auto &&state : _outputStates)
+			{
+				if (read<std::chrono::system_clock::time_point>(state, block, model::Attribute::kWriteTime) != timeStamp)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Checks that all the write states raised their written event a certain number of times
+		auto writtenEventsRaised(std::size_t count) -> bool
+		{
+			if (raiseCount(_writeState, events::kWritten) != count)
+			{
+				return false;
+			}
+			for (auto &&state : _outputStates)
+			{
+				if (raiseCount(state, events::kWritten) != count)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+	private:
+		/// @brief Gets the block the write states are stored in
+		auto writeDataBlock() noexcept -> DataBlock &
+		{
+			return _separateBlocks ? _writeDataBlock : _readDataBlock;
+		}
+
+		/// @brief Gets the block the write states are stored in
+		auto writeDataBlock() const noexcept -> const DataBlock &
+		{
+			return _separateBlocks ? _writeDataBlock : _readDataBlock;
+		}
+
+		bool _separateBlocks;
+
+		memory::Array _readDataArray;
+		DataBlock _readDataBlock { _readDataArray };
+		CommonReadState _readState;
+		ChangedInputSet _changedInputs;
+		std::vector<PerValueReadState<double>> _inputStates;
+		PendingEventList _readEventsToRaise;
+		std::vector<std::size_t> _inputNumbers;
+		DecodeTable _decodeTable;
+
+		memory::Array _writeDataArray;
+		DataBlock _writeDataBlock { _writeDataArray };
+		WriteState _writeState;
+		std::vector<WriteState> _outputStates;
+		PendingEventList _writeEventsToRaise;
+	};
+
+	/// @brief Builds a payload of big-endian 16-bit values, all of which differ between the two variants
+	auto makePayload(unsigned variant) -> std::vector<std::byte>
+	{
+		std::vector<std::byte> payload(kInputCount * kValueSize);
+		for (std::size_t index = 0; index < kInputCount; ++index)
+		{
+			payload[index * kValueSize] = std::byte(index >> 8 & 0x7f);
+			payload[index * kValueSize + 1] = std::byte(index * 2 + variant & 0xff);
+		}
+		return payload;
+	}
+
+	/// @brief The results of a stress run
+	struct Result
+	{
+		/// @brief The transaction
+		std::unique_ptr<Transaction> _transaction;
+		/// @brief Whether the inputs hold the results of the last read, and the write states those of the last write
+		bool _updatesKept { false };
+	};
+
+	/// @brief Runs read cycles and write cycles on different threads as fast as they can
+	auto stress(bool separateBlocks, std::size_t cycleCount) -> Result
+	{
+		const std::array payloadData { makePayload(0), makePayload(1) };
+		const std::array payloads { ReadCommand::Payload(0, payloadData[0]), ReadCommand::Payload(0, payloadData[1]) };
+		const auto startTime = std::chrono::system_clock::now();
+
+		auto transaction = std::make_unique<Transaction>(separateBlocks);
+		std::atomic<bool> readsDone { false };
+		std::size_t writeCycleCount = 0;
+		std::latch start { 2 };
+
+		{
+			// Keep completing writes for as long as the reads run
+			std::jthread writer([&]
+				{
+					start.arrive_and_wait();
+					while (!readsDone.load(std::memory_order_relaxed))
+					{
+						transaction->updateOutputs(startTime + std::chrono::microseconds(++writeCycleCount));
+					}
+				});
+
+			start.arrive_and_wait();
+			for (std::size_t cycle = 1; cycle <= cycleCount; ++cycle)
+			{
+				transaction->updateInputs(payloads[cycle % payloads.size()], startTime + std::chrono::microseconds(cycle));
+			}
+			readsDone = true;
+		}
+
+		// Every commit raises the events collected for it, no matter which block it goes to
+		check(transaction->inputEventsRaised(cycleCount), "every read raises the changed event of every input");
+		check(transaction->writtenEventsRaised(writeCycleCount), "every write raises the written event of every write state");
+
+		// If the write states share the read data block, each commit swaps in a buffer in which the data of the other
+		// thread is stale, so whichever thread commits last reverts the last update of the other one.
+		const auto inputsKept = transaction->inputsMatch(payloads[cycleCount % payloads.size()]) &&
+			transaction->updateTime() == startTime + std::chrono::microseconds(cycleCount);
+		const auto writesKept = transaction->writeTimesAre(startTime + std::chrono::microseconds(writeCycleCount));
+		if (separateBlocks)
+		{
+			check(inputsKept, "the inputs hold the values of the last read");
+			check(writesKept, "the write states hold the time of the last write");
+		}
+
+		return { ._transaction = std::move(transaction), ._updatesKept = inputsKept && writesKept };
+	}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	const auto cycleCount = iterationCount(argc, argv, 20000);
+
+	// Write completions committed against the read data block, like before
+	const auto shared = stress(false, cycleCount);
+	std::printf("%-20s %8zu contended commits, last updates %s\n",
+		"shared block",
+		shared._transaction->totalContention(),
+		shared._updatesKept ? "kept" : "lost");
+
+	// Write completions committed against the write data block
+	const auto separate = stress(true, cycleCount);
+	std::printf("%-20s %8zu contended input commits, %8zu contended write state commits\n",
+		"separate blocks",
+		separate._transaction->inputContention(),
+		separate._transaction->outputContention());
+
+	return exitCode();
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::data
+{
+
+/// @brief The data type of an attribute
+enum class DataType
+{
+	kBoolean,
+	kInteger,
+	kFloatingPoint,
+	kTimeStamp,
+	kQuality,
+	kErrorCode,
+	kIntegerArray,
+	kFloatingPointArray
+};
+
+} // namespace xentara::data
\ No newline at end of file
@@ -0,0 +1,18 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::data
+{
+
+/// @brief The quality of a value
+enum class Quality
+{
+	Good,
+	Acceptable,
+	Bad
+};
+
+} // namespace xentara::data
\ No newline at end of file
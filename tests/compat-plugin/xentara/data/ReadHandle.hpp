@@ -0,0 +1,64 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/utils/eh/expected.hpp>
+
+#include <cstddef>
+#include <system_error>
+#include <type_traits>
+#include <typeinfo>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::data
+{
+
+/// @brief A handle used to read the committed value of an attribute
+class ReadHandle final
+{
+public:
+	/// @brief A function that copies committed data out of the block it is stored in
+	using Reader = auto (*)(const void *block, std::size_t offset, void *target, std::size_t size) -> void;
+
+	/// @brief Constructor
+	/// @param type The type of the data
+	/// @param block The block the data is stored in
+	/// @param reader The function used to read the data from the block
+	/// @param offset The offset of the data within the block
+	/// @param size The size of the data
+	ReadHandle(const std::type_info &type, const void *block, Reader reader, std::size_t offset, std::size_t size) noexcept :
+		_type(&type), _block(block), _reader(reader), _offset(offset), _size(size)
+	{
+	}
+
+	/// @brief Reads the committed value
+	/// @return The value, or an error if the data has a different type
+	template <typename Value>
+		requires std::is_trivially_copyable_v<Value> && std::is_default_constructible_v<Value>
+	auto read() const noexcept -> utils::eh::expected<Value, std::error_code>
+	{
+		if (*_type != typeid(Value) || _size != sizeof(Value))
+		{
+			return utils::eh::unexpected(std::make_error_code(std::errc::invalid_argument));
+		}
+
+		Value value;
+		_reader(_block, _offset, &value, sizeof(value));
+		return value;
+	}
+
+private:
+	/// @brief The type of the data
+	const std::type_info *_type;
+	/// @brief The block the data is stored in
+	const void *_block;
+	/// @brief The function used to read the data
+	Reader _reader;
+	/// @brief The offset of the data within the block
+	std::size_t _offset;
+	/// @brief The size of the data
+	std::size_t _size;
+};
+
+} // namespace xentara::data
\ No newline at end of file
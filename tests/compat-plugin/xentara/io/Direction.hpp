@@ -0,0 +1,19 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::io
+{
+
+/// @brief The direction of data
+enum class Direction
+{
+	/// @brief Data that is read from an I/O component
+	Input,
+	/// @brief Data that is written to an I/O component
+	Output
+};
+
+} // namespace xentara::io
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::memory
+{
+
+/// @brief Describes the layout of the data in an ArrayBlock
+///
+/// Objects and arrays are appended one after the other, each aligned according to its type.
+class Array final
+{
+public:
+	/// @brief A handle to an object in the array
+	template <typename Object>
+	struct ObjectHandle
+	{
+		/// @brief The offset of the object
+		std::size_t _offset { 0 };
+	};
+
+	/// @brief A handle to an array of objects in the array
+	template <typename Element>
+	struct ArrayHandle
+	{
+		/// @brief The offset of the first element
+		std::size_t _offset { 0 };
+		/// @brief The number of elements
+		std::size_t _size { 0 };
+	};
+
+	/// @brief Appends a default constructed object
+	template <typename Object>
+		requires std::is_trivially_copyable_v<Object> && std::is_default_constructible_v<Object>
+	auto appendObject() -> ObjectHandle<Object>
+	{
+		return { ._offset = append<Object>(1) };
+	}
+
+	/// @brief Appends an array of default constructed objects
+	template <typename Element>
+		requires std::is_trivially_copyable_v<Element> && std::is_default_constructible_v<Element>
+	auto appendArray(std::size_t size) -> ArrayHandle<Element>
+	{
+		return { ._offset = append<Element>(size), ._size = size };
+	}
+
+	/// @brief Gets the size of the data
+	auto size() const noexcept -> std::size_t
+	{
+		return _size;
+	}
+
+	/// @brief Gets the alignment the data needs
+	auto alignment() const noexcept -> std::size_t
+	{
+		return _alignment;
+	}
+
+	/// @brief Default constructs all the objects in a buffer
+	auto initialize(std::byte *data) const -> void
+	{
+		for (auto &&initializer : _initializers)
+		{
+			initializer(data);
+		}
+	}
+
+private:
+	/// @brief Appends a number of objects
+	/// @return The offset of the first object
+	template <typename Element>
+	auto append(std::size_t count) -> std::size_t
+	{
+		const auto offset = (_size + alignof(Element) - 1) / alignof(Element) * alignof(Element);
+		_size = offset + count * sizeof(Element);
+		_alignment = std::max(_alignment, alignof(Element));
+		_initializers.push_back([offset, count](std::byte *data) { std::uninitialized_value_construct_n(reinterpret_cast<Element *>(data + offset), count); });
+		return offset;
+	}
+
+	/// @brief The size of the data
+	std::size_t _size { 0 };
+	/// @brief The alignment the data needs
+	std::size_t _alignment { alignof(std::max_align_t) };
+	/// @brief Functions that default construct the objects
+	std::vector<std::function<void(std::byte *)>> _initializers;
+};
+
+} // namespace xentara::memory
\ No newline at end of file
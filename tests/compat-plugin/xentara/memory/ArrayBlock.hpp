@@ -0,0 +1,130 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/data/ReadHandle.hpp>
+#include <xentara/memory/Array.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <typeinfo>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::memory
+{
+
+template <typename Layout>
+class WriteSentinel;
+
+/// @brief A block of data laid out according to an Array
+///
+/// Like the real memory resources, the block uses swap-in: a write sentinel writes into a scratch buffer that does not
+/// contain the committed data, and committing swaps the scratch buffer in. Only one write sentinel can be open at a time.
+class ArrayBlock final
+{
+public:
+	/// @brief Constructor
+	/// @param array The layout of the data. The layout must not change after create() has been called.
+	explicit ArrayBlock(const Array &array) noexcept : _array(array)
+	{
+	}
+
+	ArrayBlock(const ArrayBlock &) = delete;
+	auto operator=(const ArrayBlock &) -> ArrayBlock & = delete;
+
+	/// @brief Destructor
+	~ArrayBlock()
+	{
+		destroy();
+	}
+
+	/// @brief Allocates the data, and default constructs all the objects
+	auto create(std::pmr::memory_resource &resource) -> void
+	{
+		destroy();
+
+		_resource = &resource;
+		_size = std::max(_array.size(), std::size_t(1));
+		for (auto &&buffer : _buffers)
+		{
+			buffer = static_cast<std::byte *>(resource.allocate(_size, _array.alignment()));
+			std::memset(buffer, 0, _size);
+			_array.initialize(buffer);
+		}
+		_committed = 0;
+	}
+
+	/// @brief Creates a read handle for a member of an object
+	template <typename Object, typename Member>
+	auto member(Array::ObjectHandle<Object> handle, Member Object::*member) const noexcept -> data::ReadHandle
+	{
+		const auto *object = reinterpret_cast<const Object *>(_buffers[0] + handle._offset);
+		const auto memberOffset = std::size_t(reinterpret_cast<const std::byte *>(&(object->*member)) - reinterpret_cast<const std::byte *>(object));
+		return data::ReadHandle(typeid(Member), this, &readCommitted, handle._offset + memberOffset, sizeof(Member));
+	}
+
+	/// @brief Creates a read handle for an array
+	template <typename Element>
+	auto array(Array::ArrayHandle<Element> handle) const noexcept -> data::ReadHandle
+	{
+		return data::ReadHandle(typeid(Element[]), this, &readCommitted, handle._offset, handle._size * sizeof(Element));
+	}
+
+	/// @brief Gets the number of times a write sentinel had to wait for another one
+	auto contendedCount() const noexcept -> std::size_t
+	{
+		return _contendedCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	friend class WriteSentinel<Array>;
+
+	/// @brief Copies committed data
+	static auto readCommitted(const void *block, std::size_t offset, void *target, std::size_t size) -> void
+	{
+		const auto &self = *static_cast<const ArrayBlock *>(block);
+		std::scoped_lock lock(self._commitMutex);
+		std::memcpy(target, self._buffers[self._committed] + offset, size);
+	}
+
+	/// @brief Frees the data
+	auto destroy() noexcept -> void
+	{
+		if (!_resource)
+		{
+			return;
+		}
+
+		for (auto &&buffer : _buffers)
+		{
+			_resource->deallocate(buffer, _size, _array.alignment());
+			buffer = nullptr;
+		}
+		_resource = nullptr;
+	}
+
+	/// @brief The layout of the data
+	const Array &_array;
+	/// @brief The resource the buffers were allocated from
+	std::pmr::memory_resource *_resource { nullptr };
+	/// @brief The size of each buffer
+	std::size_t _size { 0 };
+	/// @brief The committed buffer and the scratch buffer
+	std::array<std::byte *, 2> _buffers {};
+	/// @brief The index of the committed buffer
+	std::size_t _committed { 0 };
+	/// @brief The lock held by the open write sentinel
+	std::mutex _writeMutex;
+	/// @brief The lock held while the buffers are swapped, and while committed data is read
+	mutable std::mutex _commitMutex;
+	/// @brief The number of times a write sentinel had to wait for another one
+	std::atomic<std::size_t> _contendedCount { 0 };
+};
+
+} // namespace xentara::memory
\ No newline at end of file
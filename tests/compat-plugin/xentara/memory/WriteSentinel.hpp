@@ -0,0 +1,117 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/memory/Array.hpp>
+#include <xentara/memory/ArrayBlock.hpp>
+#include <xentara/process/EventList.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <span>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::memory
+{
+
+/// @brief Opens an ArrayBlock for writing
+///
+/// The block stays locked until the sentinel is committed or destroyed.
+template <>
+class WriteSentinel<Array> final
+{
+public:
+	/// @brief Gives access to the committed data the sentinel was opened on
+	class OldValues final
+	{
+	public:
+		/// @brief Gets an object
+		template <typename Object>
+		auto operator[](Array::ObjectHandle<Object> handle) const noexcept -> const Object &
+		{
+			return *reinterpret_cast<const Object *>(_data + handle._offset);
+		}
+
+		/// @brief Gets an array
+		template <typename Element>
+		auto operator[](Array::ArrayHandle<Element> handle) const noexcept -> std::span<const Element>
+		{
+			return { reinterpret_cast<const Element *>(_data + handle._offset), handle._size };
+		}
+
+	private:
+		friend class WriteSentinel<Array>;
+
+		explicit OldValues(const std::byte *data) noexcept : _data(data)
+		{
+		}
+
+		/// @brief The committed data
+		const std::byte *_data;
+	};
+
+	/// @brief Constructor
+	/// @param block The block to write
+	explicit WriteSentinel(ArrayBlock &block) : _block(block), _lock(block._writeMutex, std::try_to_lock)
+	{
+		// Count it if we had to wait for another sentinel
+		if (!_lock.owns_lock())
+		{
+			_block._contendedCount.fetch_add(1, std::memory_order_relaxed);
+			_lock.lock();
+		}
+
+		// Write into the buffer that is not committed
+		_data = _block._buffers[_block._committed ^ 1];
+	}
+
+	WriteSentinel(const WriteSentinel &) = delete;
+	auto operator=(const WriteSentinel &) -> WriteSentinel & = delete;
+
+	/// @brief Gets an object
+	template <typename Object>
+	auto operator[](Array::ObjectHandle<Object> handle) noexcept -> Object &
+	{
+		return *reinterpret_cast<Object *>(_data + handle._offset);
+	}
+
+	/// @brief Gets an array
+	template <typename Element>
+	auto operator[](Array::ArrayHandle<Element> handle) noexcept -> std::span<Element>
+	{
+		return { reinterpret_cast<Element *>(_data + handle._offset), handle._size };
+	}
+
+	/// @brief Gets the committed data the sentinel was opened on
+	auto oldValues() const noexcept -> OldValues
+	{
+		return OldValues(_block._buffers[_block._committed]);
+	}
+
+	/// @brief Commits the data, unlocks the block, and raises the events
+	auto commit([[maybe_unused]] std::chrono::system_clock::time_point timeStamp, const process::FixedEventList &eventsToRaise) -> void
+	{
+		{
+			std::scoped_lock lock(_block._commitMutex);
+			_block._committed ^= 1;
+		}
+		_lock.unlock();
+
+		eventsToRaise.raise();
+	}
+
+private:
+	/// @brief The block
+	ArrayBlock &_block;
+	/// @brief The lock on the block
+	std::unique_lock<std::mutex> _lock;
+	/// @brief The buffer being written
+	std::byte *_data { nullptr };
+};
+
+/// @brief Deduces the layout from the block
+WriteSentinel(ArrayBlock &) -> WriteSentinel<Array>;
+
+} // namespace xentara::memory
\ No newline at end of file
@@ -0,0 +1,18 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <memory_resource>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::memory::memoryResources
+{
+
+/// @brief Gets the memory resource used for data blocks
+inline auto data() noexcept -> std::pmr::memory_resource &
+{
+	return *std::pmr::new_delete_resource();
+}
+
+} // namespace xentara::memory::memoryResources
\ No newline at end of file
@@ -0,0 +1,95 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/data/DataType.hpp>
+#include <xentara/utils/core/Uuid.hpp>
+
+#include <string_view>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::model
+{
+
+/// @brief An attribute of an element
+class Attribute final
+{
+public:
+	/// @brief How an attribute can be accessed
+	enum class Access
+	{
+		ReadOnly,
+		WriteOnly,
+		ReadWrite
+	};
+
+	/// @brief Constructor
+	constexpr Attribute(const utils::core::Uuid &uuid, std::string_view name, Access access, data::DataType dataType) noexcept :
+		_uuid(uuid), _name(name), _access(access), _dataType(dataType)
+	{
+	}
+
+	/// @brief Constructor for an attribute based on a predefined attribute, with different access rights and data type
+	constexpr Attribute(const Attribute &base, Access access, data::DataType dataType) noexcept :
+		_uuid(base._uuid), _name(base._name), _access(access), _dataType(dataType)
+	{
+	}
+
+	/// @brief Gets the UUID
+	constexpr auto uuid() const noexcept -> const utils::core::Uuid &
+	{
+		return _uuid;
+	}
+
+	/// @brief Gets the name
+	constexpr auto name() const noexcept -> std::string_view
+	{
+		return _name;
+	}
+
+	/// @brief Compares two attributes.
+	///
+	/// The names are compared as well, because the placeholder attributes of the driver all share the same UUID.
+	friend constexpr auto operator==(const Attribute &lhs, const Attribute &rhs) noexcept -> bool
+	{
+		return lhs._uuid == rhs._uuid && lhs._name == rhs._name;
+	}
+
+	/// @brief The error attribute
+	static const Attribute kError;
+	/// @brief The write error attribute
+	static const Attribute kWriteError;
+	/// @brief The update time attribute
+	static const Attribute kUpdateTime;
+	/// @brief The change time attribute
+	static const Attribute kChangeTime;
+	/// @brief The write time attribute
+	static const Attribute kWriteTime;
+	/// @brief The quality attribute
+	static const Attribute kQuality;
+	/// @brief The value attribute
+	static const Attribute kValue;
+
+private:
+	/// @brief The UUID
+	utils::core::Uuid _uuid;
+	/// @brief The name
+	std::string_view _name;
+	/// @brief The access rights
+	Access _access;
+	/// @brief The data type
+	data::DataType _dataType;
+};
+
+// The stand-ins use made-up UUIDs
+using namespace xentara::literals;
+inline const Attribute Attribute::kError { "00000000-0000-0000-0000-000000000001"_uuid, "error", Access::ReadOnly, data::DataType::kErrorCode };
+inline const Attribute Attribute::kWriteError { "00000000-0000-0000-0000-000000000002"_uuid, "writeError", Access::ReadOnly, data::DataType::kErrorCode };
+inline const Attribute Attribute::kUpdateTime { "00000000-0000-0000-0000-000000000003"_uuid, "updateTime", Access::ReadOnly, data::DataType::kTimeStamp };
+inline const Attribute Attribute::kChangeTime { "00000000-0000-0000-0000-000000000004"_uuid, "changeTime", Access::ReadOnly, data::DataType::kTimeStamp };
+inline const Attribute Attribute::kWriteTime { "00000000-0000-0000-0000-000000000005"_uuid, "writeTime", Access::ReadOnly, data::DataType::kTimeStamp };
+inline const Attribute Attribute::kQuality { "00000000-0000-0000-0000-000000000006"_uuid, "quality", Access::ReadOnly, data::DataType::kQuality };
+inline const Attribute Attribute::kValue { "00000000-0000-0000-0000-000000000007"_uuid, "value", Access::ReadWrite, data::DataType::kFloatingPoint };
+
+} // namespace xentara::model
\ No newline at end of file
@@ -0,0 +1,17 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/model/Attribute.hpp>
+
+#include <functional>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::model
+{
+
+/// @brief A function that is called for each attribute of an element
+using ForEachAttributeFunction = std::function<bool(const Attribute &)>;
+
+} // namespace xentara::model
\ No newline at end of file
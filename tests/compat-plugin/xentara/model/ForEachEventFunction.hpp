@@ -0,0 +1,18 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/process/Event.hpp>
+
+#include <functional>
+#include <memory>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::model
+{
+
+/// @brief A function that is called for each event of an element
+using ForEachEventFunction = std::function<bool(const process::Event::Role &, std::shared_ptr<process::Event>)>;
+
+} // namespace xentara::model
\ No newline at end of file
@@ -0,0 +1,99 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/io/Direction.hpp>
+#include <xentara/model/Attribute.hpp>
+#include <xentara/utils/core/Uuid.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::process
+{
+
+/// @brief An event that can be raised
+///
+/// The stand-in only counts how many times the event was raised.
+class Event final
+{
+public:
+	/// @brief The role of an event within its element
+	class Role final
+	{
+	public:
+		/// @brief Constructor
+		constexpr Role(const utils::core::Uuid &uuid, std::string_view name) noexcept : _uuid(uuid), _name(name)
+		{
+		}
+
+		/// @brief Constructor for the event that is raised if an attribute changes
+		constexpr Role(const model::Attribute &attribute) noexcept : _uuid(attribute.uuid()), _name(attribute.name())
+		{
+		}
+
+		/// @brief Gets the name
+		constexpr auto name() const noexcept -> std::string_view
+		{
+			return _name;
+		}
+
+		/// @brief Compares two roles.
+		///
+		/// The names are compared as well, because the placeholder events of the driver all share the same UUID.
+		friend constexpr auto operator==(const Role &lhs, const Role &rhs) noexcept -> bool
+		{
+			return lhs._uuid == rhs._uuid && lhs._name == rhs._name;
+		}
+
+	private:
+		/// @brief The UUID
+		utils::core::Uuid _uuid;
+		/// @brief The name
+		std::string_view _name;
+	};
+
+	/// @brief The role of the event that is raised if the value changes
+	static const Role kChanged;
+
+	/// @brief Constructor
+	/// @param direction The direction of the data the event belongs to
+	explicit Event(io::Direction direction) noexcept : _direction(direction)
+	{
+	}
+
+	Event(const Event &) = delete;
+	auto operator=(const Event &) -> Event & = delete;
+
+	/// @brief Raises the event
+	auto raise() noexcept -> void
+	{
+		_raiseCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// @brief Gets the number of times the event was raised
+	auto raiseCount() const noexcept -> std::size_t
+	{
+		return _raiseCount.load(std::memory_order_relaxed);
+	}
+
+	/// @brief Gets the direction of the data the event belongs to
+	auto direction() const noexcept -> io::Direction
+	{
+		return _direction;
+	}
+
+private:
+	/// @brief The direction of the data the event belongs to
+	io::Direction _direction;
+	/// @brief The number of times the event was raised
+	std::atomic<std::size_t> _raiseCount { 0 };
+};
+
+// The stand-ins use made-up UUIDs
+inline const Event::Role Event::kChanged { model::Attribute::kValue };
+
+} // namespace xentara::process
\ No newline at end of file
@@ -0,0 +1,29 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <xentara/process/Event.hpp>
+#include <xentara/utils/core/FixedVector.hpp>
+
+#include <functional>
+
+/// @file
+/// @brief A stand-in for the Xentara plugin library header, used to build the tests without the Xentara development environment
+
+namespace xentara::process
+{
+
+/// @brief A list of events to raise, whose capacity is set once
+class FixedEventList final : public utils::core::FixedVector<std::reference_wrapper<Event>>
+{
+public:
+	/// @brief Raises all the events in the list
+	auto raise() const noexcept -> void
+	{
+		for (auto &&event : *this)
+		{
+			event.get().raise();
+		}
+	}
+};
+
+} // namespace xentara::process
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <atomic>
+#include <optional>
+
+/// @file
+/// @brief A stand-in for the Xentara utility library header, used to build the tests without the Xentara development environment
+
+namespace xentara::utils::atomic
+{
+
+/// @brief An atomic optional value
+template <typename Value>
+class Optional
+{
+public:
+	/// @brief Whether the value is always lock-free
+	static constexpr bool is_always_lock_free = std::atomic<std::optional<Value>>::is_always_lock_free;
+
+	/// @brief Stores a value
+	auto store(const Value &value, std::memory_order order = std::memory_order_seq_cst) noexcept -> void
+	{
+		_value.store(value, order);
+	}
+
+	/// @brief Replaces the value and returns the old one
+	auto exchange(std::nullopt_t, std::memory_order order = std::memory_order_seq_cst) noexcept -> std::optional<Value>
+	{
+		return _value.exchange(std::nullopt, order);
+	}
+
+private:
+	/// @brief The value
+	std::atomic<std::optional<Value>> _value;
+};
+
+} // namespace xentara::utils::atomic
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/// @file
+/// @brief A stand-in for the Xentara utility library header, used to build the tests without the Xentara development environment
+
+namespace xentara::utils::core
+{
+
+/// @brief A vector whose capacity is set once, and that never allocates memory when elements are added
+template <typename Element>
+class FixedVector
+{
+public:
+	/// @brief Removes all elements and sets the capacity
+	auto reset(std::size_t capacity) -> void
+	{
+		_elements.clear();
+		_elements.shrink_to_fit();
+		_elements.reserve(capacity);
+	}
+
+	/// @brief Adds an element. The capacity must not be exceeded.
+	auto push_back(const Element &element) noexcept -> void
+	{
+		assert(_elements.size() < _elements.capacity());
+		_elements.push_back(element);
+	}
+
+	/// @brief Removes all elements, keeping the capacity
+	auto clear() noexcept -> void
+	{
+		_elements.clear();
+	}
+
+	/// @brief Gets the number of elements
+	auto size() const noexcept -> std::size_t
+	{
+		return _elements.size();
+	}
+
+	/// @brief Checks whether there are no elements
+	auto empty() const noexcept -> bool
+	{
+		return _elements.empty();
+	}
+
+	/// @brief Gets the maximum number of elements
+	auto capacity() const noexcept -> std::size_t
+	{
+		return _elements.capacity();
+	}
+
+	/// @brief Gets an iterator to the first element
+	auto begin() const noexcept
+	{
+		return _elements.begin();
+	}
+
+	/// @brief Gets an iterator past the last element
+	auto end() const noexcept
+	{
+		return _elements.end();
+	}
+
+private:
+	/// @brief The elements
+	std::vector<Element> _elements;
+};
+
+} // namespace xentara::utils::core
\ No newline at end of file
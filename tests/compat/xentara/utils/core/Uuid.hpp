@@ -0,0 +1,84 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+
+/// @file
+/// @brief A stand-in for the Xentara utility library header, used to build the tests without the Xentara development environment
+
+namespace xentara::utils::core
+{
+
+/// @brief A UUID
+class Uuid final
+{
+public:
+	/// @brief Default constructor for the nil UUID
+	constexpr Uuid() noexcept = default;
+
+	/// @brief Constructor
+	/// @param bytes The bytes of the UUID
+	constexpr explicit Uuid(const std::array<std::uint8_t, 16> &bytes) noexcept : _bytes(bytes)
+	{
+	}
+
+	/// @brief Compares two UUIDs
+	constexpr auto operator<=>(const Uuid &) const noexcept = default;
+
+private:
+	/// @brief The bytes
+	std::array<std::uint8_t, 16> _bytes {};
+};
+
+} // namespace xentara::utils::core
+
+namespace xentara::literals
+{
+
+/// @brief Parses a UUID of the form "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"
+consteval auto operator""_uuid(const char *string, std::size_t length) -> utils::core::Uuid
+{
+	const auto digit = [](char character) -> std::uint8_t
+	{
+		if (character >= '0' && character <= '9')
+		{
+			return std::uint8_t(character - '0');
+		}
+		if (character >= 'a' && character <= 'f')
+		{
+			return std::uint8_t(character - 'a' + 10);
+		}
+		if (character >= 'A' && character <= 'F')
+		{
+			return std::uint8_t(character - 'A' + 10);
+		}
+		throw "invalid UUID";
+	};
+
+	std::array<std::uint8_t, 16> bytes {};
+	std::size_t digitCount = 0;
+	for (std::size_t index = 0; index < length; ++index)
+	{
+		if (string[index] == '-')
+		{
+			continue;
+		}
+		if (digitCount == 32)
+		{
+			throw "invalid UUID";
+		}
+		bytes[digitCount / 2] = std::uint8_t((bytes[digitCount / 2] << 4) | digit(string[index]));
+		++digitCount;
+	}
+	if (digitCount != 32)
+	{
+		throw "invalid UUID";
+	}
+
+	return utils::core::Uuid(bytes);
+}
+
+} // namespace xentara::literals
\ No newline at end of file
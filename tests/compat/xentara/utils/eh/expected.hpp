@@ -0,0 +1,21 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+#include <expected>
+
+/// @file
+/// @brief A stand-in for the Xentara utility library header, used to build the tests without the Xentara development environment
+
+namespace xentara::utils::eh
+{
+
+using std::expected;
+
+/// @brief Creates an object representing an error
+template <typename Error>
+constexpr auto unexpected(Error error) -> std::unexpected<Error>
+{
+	return std::unexpected<Error>(std::move(error));
+}
+
+} // namespace xentara::utils::eh
\ No newline at end of file
@@ -0,0 +1,19 @@
+// Copyright (c) embedded ocean GmbH
+#pragma once
+
+/// @file
+/// @brief A stand-in for the Xentara utility library header, used to build the tests without the Xentara development environment
+
+namespace xentara::utils::tools
+{
+
+/// @brief A base class for classes that can be neither copied nor moved
+class Unique
+{
+public:
+	Unique() = default;
+	Unique(const Unique &) = delete;
+	auto operator=(const Unique &) -> Unique & = delete;
+};
+
+} // namespace xentara::utils::tools
\ No newline at end of file